@@ -285,6 +285,15 @@ if(HDF5_FOUND)
   #
   set(libmpdataxx_LIBRARIES "${libmpdataxx_LIBRARIES};${HDF5_LIBRARIES}")
   set(libmpdataxx_INCLUDE_DIRS "${libmpdataxx_INCLUDE_DIRS};${HDF5_INCLUDE_DIRS}")
+
+  # zlib used directly for the multi-threaded compression of HDF5 output
+  find_package(ZLIB)
+  if(ZLIB_FOUND)
+    set(libmpdataxx_LIBRARIES "${libmpdataxx_LIBRARIES};${ZLIB_LIBRARIES}")
+    set(libmpdataxx_INCLUDE_DIRS "${libmpdataxx_INCLUDE_DIRS};${ZLIB_INCLUDE_DIRS}")
+    set(libmpdataxx_CXX_FLAGS_DEBUG "${libmpdataxx_CXX_FLAGS_DEBUG} -DLIBMPDATAXX_HAVE_ZLIB")
+    set(libmpdataxx_CXX_FLAGS_RELEASE "${libmpdataxx_CXX_FLAGS_RELEASE} -DLIBMPDATAXX_HAVE_ZLIB")
+  endif()
 else()
   message(STATUS "HDF5 not found. 
 
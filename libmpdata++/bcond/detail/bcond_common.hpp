@@ -8,6 +8,8 @@
 #include <libmpdata++/formulae/arakawa_c.hpp>
 #include <libmpdata++/formulae/idxperm.hpp>
 
+#include <vector>
+
 namespace libmpdataxx
 {
   namespace bcond
@@ -129,6 +131,23 @@ namespace libmpdataxx
           assert(false && "bcond::fill_halos_sclr() called!");
         };
 
+        // split-phase fill_halos_sclr(): communication launched by start_fill_halos_sclr() may be overlapped
+        // with computations not involving the halo and is completed by finish_fill_halos_sclr()
+        // (bconds other than remote fill the halo in the first call)
+        virtual void start_fill_halos_sclr(arr_3d_t &a, const rng_t &j, const rng_t &k, const bool deriv = false)
+        {
+          fill_halos_sclr(a, j, k, deriv);
+        };
+
+        virtual void finish_fill_halos_sclr(arr_3d_t &, const rng_t &, const rng_t &)
+        {};
+
+        // as above but for several arrays (one after another unless overridden, see remote_3d)
+        virtual void fill_halos_sclrs(const std::vector<arr_3d_t*> &arrs, const rng_t &j, const rng_t &k, const bool deriv = false)
+        {
+          for (auto a : arrs) fill_halos_sclr(*a, j, k, deriv);
+        };
+
         virtual void fill_halos_pres(arr_3d_t &, const rng_t &, const rng_t &)
         {
           assert(false && "bcond::fill_halos_pres() called!");
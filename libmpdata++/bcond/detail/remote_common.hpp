@@ -7,10 +7,17 @@
 
 #include <libmpdata++/bcond/detail/bcond_common.hpp>
 
+#include <vector>
+#include <algorithm>
+
 #if defined(USE_MPI)
 #  include <boost/serialization/vector.hpp>
 #  include <boost/mpi/communicator.hpp>
 #  include <boost/mpi/nonblocking.hpp>
+#  include <boost/mpi/datatype.hpp>
+#  include <map>
+#  include <cstdlib>
+#  include <cstring>
 #endif
 
 namespace libmpdataxx
@@ -35,8 +42,17 @@ namespace libmpdataxx
 
 #if defined(USE_MPI)
         boost::mpi::communicator mpicom;
-        real_t *buf_send,
-               *buf_recv;
+        real_t *buf_send = nullptr,
+               *buf_recv = nullptr;
+        std::size_t
+          buf_send_size = 0, // number of elements allocated in the buffers
+          buf_recv_size = 0;
+
+        // sending directly from and receiving directly into the arrays, see datatypes_requested()
+        const bool use_dtypes = datatypes_requested();
+        std::map<std::vector<int>, MPI_Datatype> dtypes; // see dtype()
+        MPI_Request dt_reqs[2] = {MPI_REQUEST_NULL, MPI_REQUEST_NULL}; // send, recv
+        bool recv_direct = false; // true if the data being received goes directly to the array
 
 #  if defined(NDEBUG)
         static const int n_reqs = 2; // data, reqs for recv only is enough?
@@ -48,24 +64,23 @@ namespace libmpdataxx
 
         std::array<boost::mpi::request, n_reqs> reqs;
 
-        const int peer = dir == left
-          ? (mpicom.rank() - 1 + mpicom.size()) % mpicom.size()
-          : (mpicom.rank() + 1                ) % mpicom.size();
-
 #  if !defined(NDEBUG)
           const int debug = 2;
           std::pair<int, int> buf_rng;
 #  endif
 #endif
 
+        const int peer; // rank of the neighbouring process (the same in mpicom and in the Cartesian communicator of distmem)
+        const int tag;  // distinguishes the messages exchanged with peer by different bconds, see msg_tag()
+
+        // tag of the messages sent in the direction d (the second bit left for the debug messages)
+        int msg_tag(const drctn_e d) const
+        {
+          return 4 * tag + d;
+        }
+
         protected:
-        const bool is_cyclic =
-#if defined(USE_MPI)
-          (dir == left && mpicom.rank() == 0) ||
-          (dir == rght && mpicom.rank() == mpicom.size()-1);
-#else
-          false;
-#endif
+        const bool is_cyclic; // true if at the edge of the domain, i.e. exchanging halos with the other edge
 
         void send_hlpr(
           const arr_t &a,
@@ -76,28 +91,37 @@ namespace libmpdataxx
           // distinguishing between left and right messages
           // (important e.g. with 2 procs and cyclic bc)
           const int
-            msg_send = dir == left ? left : rght;
+            msg_send = msg_tag(dir == left ? left : rght);
 
-          // arr_send references part of the send buffer that will be used
-          arr_t arr_send(buf_send, a(idx_send).shape(), blitz::neverDeleteData);
-          // copying data to be sent
-          arr_send = a(idx_send);
+          if (a(idx_send).size() == 0) return;
 
-          // launching async data transfer
-          if(arr_send.size()!=0)
+          if (use_dtypes && subarray_layout(a))
           {
+            // sending directly from the array
+            MPI_Isend(const_cast<real_t*>(a.dataFirst()), 1, dtype(a, idx_send), peer, msg_send, MPI_Comm(mpicom), &dt_reqs[0]);
+          }
+          else
+          {
+            reserve(buf_send, buf_send_size, a(idx_send).size());
+
+            // arr_send references part of the send buffer that will be used
+            arr_t arr_send(buf_send, a(idx_send).shape(), blitz::neverDeleteData);
+            // copying data to be sent
+            arr_send = a(idx_send);
+
+            // launching async data transfer
             // use the pointer+size kind of send instead of serialization of blitz arrays, because
             // serialization caused memory leaks, probably because it breaks blitz reference counting
             reqs[0] = mpicom.isend(peer, msg_send, buf_send, arr_send.size());
+          }
 
-            // sending debug information
+          // sending debug information
 #  if !defined(NDEBUG)
-            reqs[1] = mpicom.isend(peer, msg_send ^ debug, std::pair<int,int>(
-              idx_send[0].first(),
-              idx_send[0].last()
-            ));
+          reqs[1] = mpicom.isend(peer, msg_send ^ debug, std::pair<int,int>(
+            idx_send[0].first(),
+            idx_send[0].last()
+          ));
 #  endif
-          }
 #else
           assert(false);
 #endif
@@ -110,13 +134,23 @@ namespace libmpdataxx
         {
 #if defined(USE_MPI)
           const int
-            msg_recv = dir == left ? rght : left;
+            msg_recv = msg_tag(dir == left ? rght : left);
 
+          recv_direct = use_dtypes && subarray_layout(a);
 
           // launching async data transfer
           if(a(idx_recv).size()!=0) // TODO: test directly size of idx_recv
           {
-            reqs[1+n_dbg_reqs] = mpicom.irecv(peer, msg_recv, buf_recv, a(idx_recv).size());
+            if (recv_direct)
+            {
+              // receiving directly into the array
+              MPI_Irecv(const_cast<real_t*>(a.dataFirst()), 1, dtype(a, idx_recv), peer, msg_recv, MPI_Comm(mpicom), &dt_reqs[1]);
+            }
+            else
+            {
+              reserve(buf_recv, buf_recv_size, a(idx_recv).size());
+              reqs[1+n_dbg_reqs] = mpicom.irecv(peer, msg_recv, buf_recv, a(idx_recv).size());
+            }
 
             // sending debug information
 #  if !defined(NDEBUG)
@@ -138,6 +172,7 @@ namespace libmpdataxx
 
           // waiting for the transfers to finish
           boost::mpi::wait_all(reqs.begin(), reqs.begin() + 1 + n_dbg_reqs); // MPI_Waitall is thread-safe?
+          MPI_Wait(&dt_reqs[0], MPI_STATUS_IGNORE);
 #else
           assert(false);
 #endif
@@ -154,6 +189,8 @@ namespace libmpdataxx
 
           // waiting for the transfers to finish
           boost::mpi::wait_all(reqs.begin() + 1 + n_dbg_reqs, reqs.end()); // MPI_Waitall is thread-safe?
+          MPI_Wait(&dt_reqs[1], MPI_STATUS_IGNORE);
+          if (recv_direct) return;
 
           // a blitz handler for the used part of the receive buffer
           arr_t arr_recv(buf_recv, a(idx_recv).shape(), blitz::neverDeleteData); // TODO: shape directly from idx_recv
@@ -172,7 +209,9 @@ namespace libmpdataxx
 #endif
         }
 
-        void xchng(
+        // split-phase xchng(): the transfers launched by start_xchng() are completed by finish_xchng(),
+        // the halo (and the buffers) must not be used in between
+        void start_xchng(
           const arr_t &a,
           const idx_t &idx_send,
           const idx_t &idx_recv
@@ -181,9 +220,21 @@ namespace libmpdataxx
 #if defined(USE_MPI)
           send_hlpr(a, idx_send);
           recv_hlpr(a, idx_recv);
+#else
+          assert(false);
+#endif
+        }
 
+        void finish_xchng(
+          const arr_t &a,
+          const idx_t &idx_recv
+        )
+        {
+#if defined(USE_MPI)
           // waiting for the transfers to finish
           boost::mpi::wait_all(reqs.begin(), reqs.end());
+          MPI_Waitall(2, dt_reqs, MPI_STATUSES_IGNORE);
+          if (recv_direct) return;
 
           // a blitz handler for the used part of the receive buffer
           arr_t arr_recv(buf_recv, a(idx_recv).shape(), blitz::neverDeleteData);
@@ -202,23 +253,160 @@ namespace libmpdataxx
 #endif
         }
 
+        void xchng(
+          const arr_t &a,
+          const idx_t &idx_send,
+          const idx_t &idx_recv
+        )
+        {
+          start_xchng(a, idx_send, idx_recv);
+          finish_xchng(a, idx_recv);
+        }
+
+        // as above but for several arrays, with the slices of all of them sent in a single message
+        void xchng(
+          const std::vector<arr_t*> &arrs,
+          const idx_t &idx_send,
+          const idx_t &idx_recv
+        )
+        {
+#if defined(USE_MPI)
+          if (arrs.size() == 1) return xchng(*arrs[0], idx_send, idx_recv);
+
+          const int
+            msg_send = msg_tag(dir == left ? left : rght),
+            msg_recv = msg_tag(dir == left ? rght : left);
+
+          const auto
+            shape_send = (*arrs[0])(idx_send).shape(),
+            shape_recv = (*arrs[0])(idx_recv).shape();
+          const std::size_t
+            n_send = blitz::product(shape_send),
+            n_recv = blitz::product(shape_recv);
+
+          reserve(buf_send, buf_send_size, arrs.size() * n_send);
+          reserve(buf_recv, buf_recv_size, arrs.size() * n_recv);
+
+          // copying data to be sent, one slice after another
+          for (std::size_t i = 0; i < arrs.size(); ++i)
+          {
+            arr_t arr_send(buf_send + i * n_send, shape_send, blitz::neverDeleteData);
+            arr_send = (*arrs[i])(idx_send);
+          }
+
+          // launching async data transfer
+          if (n_send != 0)
+          {
+            reqs[0] = mpicom.isend(peer, msg_send, buf_send, arrs.size() * n_send);
+#  if !defined(NDEBUG)
+            reqs[1] = mpicom.isend(peer, msg_send ^ debug, std::pair<int,int>(
+              idx_send[0].first(),
+              idx_send[0].last()
+            ));
+#  endif
+          }
+          if (n_recv != 0)
+          {
+            reqs[1+n_dbg_reqs] = mpicom.irecv(peer, msg_recv, buf_recv, arrs.size() * n_recv);
+#  if !defined(NDEBUG)
+            reqs[3] = mpicom.irecv(peer, msg_recv ^ debug, buf_rng);
+#  endif
+          }
+
+          // waiting for the transfers to finish
+          boost::mpi::wait_all(reqs.begin(), reqs.end());
+
+          // writing received data to the arrays
+          for (std::size_t i = 0; i < arrs.size(); ++i)
+          {
+            arr_t arr_recv(buf_recv + i * n_recv, shape_recv, blitz::neverDeleteData);
+            (*arrs[i])(idx_recv) = arr_recv;
+          }
+#else
+          assert(false);
+#endif
+        }
+
+        private:
+
+#if defined(USE_MPI)
+        // growing a buffer if needed (only called after all transfers using it completed)
+        static void reserve(real_t *&buf, std::size_t &size, const std::size_t n)
+        {
+          if (n <= size) return;
+          buf = (real_t *) realloc(buf, n * sizeof(real_t));
+          size = n;
+        }
+
+        // true if a slice of the array can be described with MPI_Type_create_subarray()
+        static bool subarray_layout(const arr_t &a)
+        {
+          if (!a.isStorageContiguous()) return false;
+          for (int d = 0; d < n_dims; ++d)
+            if (a.ordering(d) != n_dims - 1 - d || !a.isRankStoredAscending(d)) return false;
+          return true;
+        }
+
+        // derived datatype of the slice idx of arrays shaped like a, created once and cached
+        MPI_Datatype dtype(const arr_t &a, const idx_t &idx)
+        {
+          std::vector<int> key; // shape of the array, offset and extents of the slice
+          for (int d = 0; d < n_dims; ++d)
+          {
+            key.push_back(a.extent(d));
+            key.push_back(idx.lbound(d) - a.lbound(d));
+            key.push_back(idx.ubound(d) - idx.lbound(d) + 1);
+          }
+
+          auto it = dtypes.find(key);
+          if (it != dtypes.end()) return it->second;
+
+          int sizes[n_dims], subsizes[n_dims], starts[n_dims];
+          for (int d = 0; d < n_dims; ++d)
+          {
+            sizes[d]    = key[3 * d];
+            starts[d]   = key[3 * d + 1];
+            subsizes[d] = key[3 * d + 2];
+          }
+
+          MPI_Datatype type;
+          MPI_Type_create_subarray(n_dims, sizes, subsizes, starts, MPI_ORDER_C, boost::mpi::get_mpi_datatype<real_t>(real_t()), &type);
+          MPI_Type_commit(&type);
+          return dtypes[key] = type;
+        }
+
+        // true if the halos are sent directly from and received directly into the arrays (if contiguous) using
+        // MPI derived datatypes instead of being copied through buffers: at compile time with LIBMPDATAXX_MPI_DATATYPES
+        // defined or at run time with the LIBMPDATAXX_MPI_HALO environment variable set to "datatypes"
+        // (the latter, if set, takes precedence; "buffers" selects the copying)
+        static bool datatypes_requested()
+        {
+          const char *env_var = std::getenv("LIBMPDATAXX_MPI_HALO");
+          if (env_var != NULL) return std::strcmp(env_var, "datatypes") == 0;
+#  if defined(LIBMPDATAXX_MPI_DATATYPES)
+          return true;
+#  else
+          return false;
+#  endif
+        }
+#endif
+
         public:
 
         // ctor
         remote_common(
           const rng_t &i,
-          const std::array<int, n_dims> &grid_size
+          const std::array<int, n_dims> &grid_size,
+          const int peer,
+          const bool is_cyclic,
+          const int tag
         ) :
           parent_t(i, grid_size),
-          grid_size_0(grid_size[0])
-        {
-#if defined(USE_MPI)
-          const int slice_size = n_dims==1 ? 1 : (n_dims==2? grid_size[1]+6 : (grid_size[1]+6) * (grid_size[2]+6) ); // 3 is the max halo size (?), so 6 on both sides
-          // allocate enough memory in buffers to store largest halos to be sent
-          buf_send = (real_t *) malloc(halo * slice_size * sizeof(real_t));
-          buf_recv = (real_t *) malloc(halo * slice_size * sizeof(real_t));
-#endif
-        }
+          grid_size_0(grid_size[0]),
+          peer(peer),
+          tag(tag),
+          is_cyclic(is_cyclic)
+        {}
 
         // dtor
         ~remote_common()
@@ -226,6 +414,11 @@ namespace libmpdataxx
 #if defined(USE_MPI)
           free(buf_send);
           free(buf_recv);
+
+          int finalized;
+          MPI_Finalized(&finalized);
+          if (!finalized)
+            for (auto &t : dtypes) MPI_Type_free(&t.second);
 #endif
         }
       };
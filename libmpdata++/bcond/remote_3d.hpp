@@ -35,6 +35,24 @@ namespace libmpdataxx
         this->xchng(a, pi<d>(this->left_intr_sclr + off, j, k), pi<d>(this->left_halo_sclr, j, k));
       }
 
+      void fill_halos_sclrs(const std::vector<arr_t*> &arrs, const rng_t &j, const rng_t &k, const bool deriv = false)
+      {
+        using namespace idxperm;
+        this->xchng(arrs, pi<d>(this->left_intr_sclr + off, j, k), pi<d>(this->left_halo_sclr, j, k));
+      }
+
+      void start_fill_halos_sclr(arr_t &a, const rng_t &j, const rng_t &k, const bool deriv = false)
+      {
+        using namespace idxperm;
+        this->start_xchng(a, pi<d>(this->left_intr_sclr + off, j, k), pi<d>(this->left_halo_sclr, j, k));
+      }
+
+      void finish_fill_halos_sclr(arr_t &a, const rng_t &j, const rng_t &k)
+      {
+        using namespace idxperm;
+        this->finish_xchng(a, pi<d>(this->left_halo_sclr, j, k));
+      }
+
       void fill_halos_pres(arr_t &a, const rng_t &j, const rng_t &k)
       {
         fill_halos_sclr(a, j, k);
@@ -52,12 +70,12 @@ namespace libmpdataxx
         {
           if(halo == 1)
             // see remote_2d
-            this->send(av[0], pi<d>(this->left_intr_vctr + off, j, k)); // TODO: no need to receive? the vector in halo was calculated anyway?
+            this->send(av[d], pi<d>(this->left_intr_vctr + off, j, k)); // TODO: no need to receive? the vector in halo was calculated anyway?
           else
-            this->xchng(av[0], pi<d>(this->left_intr_vctr + off, j, k), pi<d>((this->left_halo_vctr^h)^(-1), j, k)); // ditto
+            this->xchng(av[d], pi<d>(this->left_intr_vctr + off, j, k), pi<d>((this->left_halo_vctr^h)^(-1), j, k)); // ditto
         }
         else
-          this->xchng(av[0], pi<d>(this->left_intr_vctr + off, j, k), pi<d>(this->left_halo_vctr, j, k));
+          this->xchng(av[d], pi<d>(this->left_intr_vctr + off, j, k), pi<d>(this->left_halo_vctr, j, k));
       }
 
       void fill_halos_sgs_div(arr_t &a, const rng_t &j, const rng_t &k)
@@ -73,12 +91,12 @@ namespace libmpdataxx
         {
           if(halo == 1)
             // see remote_2d
-            this->send(av[0 + offset], pi<d>(this->left_intr_vctr + off, j, k));
+            this->send(av[d + offset], pi<d>(this->left_intr_vctr + off, j, k));
           else
-            this->xchng(av[0 + offset], pi<d>(this->left_intr_vctr + off, j, k), pi<d>((this->left_halo_vctr^h)^(-1), j, k));
+            this->xchng(av[d + offset], pi<d>(this->left_intr_vctr + off, j, k), pi<d>((this->left_halo_vctr^h)^(-1), j, k));
         }
         else
-          this->xchng(av[0 + offset], pi<d>(this->left_intr_vctr + off, j, k), pi<d>(this->left_halo_vctr, j, k));
+          this->xchng(av[d + offset], pi<d>(this->left_intr_vctr + off, j, k), pi<d>(this->left_halo_vctr, j, k));
       }
 
       void fill_halos_sgs_tnsr(arrvec_t<arr_t> &av, const arr_t &, const arr_t &, const rng_t &j, const rng_t &k, const real_t)
@@ -147,6 +165,24 @@ namespace libmpdataxx
         this->xchng(a, pi<d>(this->rght_intr_sclr + off, j, k), pi<d>(this->rght_halo_sclr, j, k));
       }
 
+      void fill_halos_sclrs(const std::vector<arr_t*> &arrs, const rng_t &j, const rng_t &k, const bool deriv = false)
+      {
+        using namespace idxperm;
+        this->xchng(arrs, pi<d>(this->rght_intr_sclr + off, j, k), pi<d>(this->rght_halo_sclr, j, k));
+      }
+
+      void start_fill_halos_sclr(arr_t &a, const rng_t &j, const rng_t &k, const bool deriv = false)
+      {
+        using namespace idxperm;
+        this->start_xchng(a, pi<d>(this->rght_intr_sclr + off, j, k), pi<d>(this->rght_halo_sclr, j, k));
+      }
+
+      void finish_fill_halos_sclr(arr_t &a, const rng_t &j, const rng_t &k)
+      {
+        using namespace idxperm;
+        this->finish_xchng(a, pi<d>(this->rght_halo_sclr, j, k));
+      }
+
       void fill_halos_pres(arr_t &a, const rng_t &j, const rng_t &k)
       {
         fill_halos_sclr(a, j, k);
@@ -163,12 +199,12 @@ namespace libmpdataxx
         if(!this->is_cyclic)
         {
           if(halo == 1)
-            this->recv(av[0], pi<d>(this->rght_halo_vctr, j, k));
+            this->recv(av[d], pi<d>(this->rght_halo_vctr, j, k));
           else
-            this->xchng(av[0], pi<d>(((this->rght_intr_vctr + off)^h)^(-1), j, k), pi<d>(this->rght_halo_vctr, j, k));
+            this->xchng(av[d], pi<d>(((this->rght_intr_vctr + off)^h)^(-1), j, k), pi<d>(this->rght_halo_vctr, j, k));
         }
         else
-          this->xchng(av[0], pi<d>(this->rght_intr_vctr + off, j, k), pi<d>(this->rght_halo_vctr, j, k));
+          this->xchng(av[d], pi<d>(this->rght_intr_vctr + off, j, k), pi<d>(this->rght_halo_vctr, j, k));
       }
 
       void fill_halos_sgs_div(arr_t &a, const rng_t &j, const rng_t &k)
@@ -183,12 +219,12 @@ namespace libmpdataxx
         if(!this->is_cyclic)
         {
           if(halo == 1)
-            this->recv(av[0 + offset], pi<d>(this->rght_halo_vctr, j, k));
+            this->recv(av[d + offset], pi<d>(this->rght_halo_vctr, j, k));
           else
-            this->xchng(av[0 + offset], pi<d>(((this->rght_intr_vctr + off)^h)^(-1), j, k), pi<d>(this->rght_halo_vctr, j, k));
+            this->xchng(av[d + offset], pi<d>(((this->rght_intr_vctr + off)^h)^(-1), j, k), pi<d>(this->rght_halo_vctr, j, k));
         }
         else
-          this->xchng(av[0 + offset], pi<d>(this->rght_intr_vctr + off, j, k), pi<d>(this->rght_halo_vctr, j, k));
+          this->xchng(av[d + offset], pi<d>(this->rght_intr_vctr + off, j, k), pi<d>(this->rght_halo_vctr, j, k));
       }
 
       void fill_halos_sgs_tnsr(arrvec_t<arr_t> &av, const arr_t &, const arr_t &, const rng_t &j, const rng_t &k, const real_t)
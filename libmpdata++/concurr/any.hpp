@@ -7,6 +7,9 @@
 #pragma once
 
 #include <libmpdata++/blitz.hpp>
+#include <libmpdata++/concurr/detail/footprint.hpp>
+
+#include <string>
 
 namespace libmpdataxx
 {
@@ -69,6 +72,41 @@ namespace libmpdataxx
       const real_t max(int eqn = 0) const
       { assert(false); throw; }
 
+      // the n-th most recent record (n = 0 for the latest) of an output variable kept by
+      // output::memory, in the indices of the (possibly downsampled) output grid; the data
+      // is overwritten by subsequent records
+      virtual
+      blitz::Array<real_t, n_dims> history(const std::string &name, int n = 0)
+      { assert(false); throw; }
+
+      // time of the record above
+      virtual
+      const real_t history_time(const std::string &name, int n = 0)
+      { assert(false); throw; }
+
+      // number of records of an output variable kept by output::memory
+      virtual
+      int history_size(const std::string &name)
+      { assert(false); throw; }
+
+      // memory taken by the arrays shared between threads
+      virtual
+      detail::footprint_t footprint()
+      { assert(false); throw; }
+
+      // saves the state of the solvers (all shared arrays including halos, and the per-thread
+      // scalars such as time, timestep or time-level indices) to path (suffixed with the rank
+      // of the process if running with MPI)
+      virtual
+      void checkpoint(const std::string &path)
+      { assert(false); throw; }
+
+      // loads the state saved by checkpoint() with the same solver, grid, number of threads
+      // and MPI processes; subsequent advance() continues the run as if it was not interrupted
+      virtual
+      void restart(const std::string &path)
+      { assert(false); throw; }
+
       // dtor
       virtual ~any() {}
     };
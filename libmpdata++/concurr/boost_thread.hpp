@@ -7,6 +7,7 @@
 #pragma once
 
 #include <libmpdata++/concurr/detail/concurr_common.hpp>
+#include <libmpdata++/concurr/detail/spin_barrier.hpp>
 
 #include <boost/thread.hpp>
 
@@ -32,7 +33,7 @@ namespace libmpdataxx
 
       class mem_t : public parent_t::mem_t
       {
-        boost::barrier b;
+        detail::selectable_barrier<boost::barrier> b;
 
         public:
 
@@ -49,11 +50,17 @@ namespace libmpdataxx
           return nthreads;
         }
 
+        // the number of threads requested, reduced to one that the grid can be decomposed into
+        static int size(const std::array<int, solver_t::n_dims> &grid_size)
+        {
+          return size(parent_t::mem_t::fit_size(grid_size, size(parent_t::mem_t::max_size(grid_size))));
+        }
+
 
         // ctor
         mem_t(const std::array<int, solver_t::n_dims> &grid_size) :
-          b(size(grid_size[0])),
-          parent_t::mem_t(grid_size, size(grid_size[0]))
+          b(size(grid_size)),
+          parent_t::mem_t(grid_size, size(grid_size))
         {};
 
         void barrier()
@@ -79,9 +86,17 @@ namespace libmpdataxx
         threads.join_all();
       }
 
+      void run(const std::function<void(int)> &job)
+      {
+        boost::thread_group threads;
+        for (int i = 0; i < this->algos.size(); ++i)
+          threads.create_thread([&job, i]() { job(i); });
+        threads.join_all();
+      }
+
       // ctor
       boost_thread(const typename solver_t::rt_params_t &p) :
-        parent_t(p, new mem_t(p.grid_size), mem_t::size(p.grid_size[0]))
+        parent_t(p, new mem_t(p.grid_size), mem_t::size(p.grid_size))
       {}
 
     };
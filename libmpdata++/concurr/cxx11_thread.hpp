@@ -7,6 +7,8 @@
 #pragma once
 
 #include <libmpdata++/concurr/detail/concurr_common.hpp>
+#include <libmpdata++/concurr/detail/spin_barrier.hpp>
+#include <libmpdata++/concurr/detail/thread_pool.hpp>
 
 #include <thread>
 #include <mutex>
@@ -74,7 +76,7 @@ namespace libmpdataxx
 
       class mem_t : public parent_t::mem_t
       {
-        detail::barrier b;
+        detail::selectable_barrier<detail::barrier> b;
 
         public:
 
@@ -91,10 +93,16 @@ namespace libmpdataxx
           return nthreads;
         }
 
+        // the number of threads requested, reduced to one that the grid can be decomposed into
+        static int size(const std::array<int, solver_t::n_dims> &grid_size)
+        {
+          return size(parent_t::mem_t::fit_size(grid_size, size(parent_t::mem_t::max_size(grid_size))));
+        }
+
         // ctor
         mem_t(const std::array<int, solver_t::n_dims> &grid_size) :
-          b(size(grid_size[0])),
-          parent_t::mem_t(grid_size, size(grid_size[0]))
+          b(size(grid_size)),
+          parent_t::mem_t(grid_size, size(grid_size))
         {};
 
         void barrier()
@@ -103,24 +111,30 @@ namespace libmpdataxx
         }
       };
 
+      // threads reused by subsequent advance() calls
+      std::unique_ptr<detail::thread_pool> pool;
+
       public:
 
       void solve(typename parent_t::advance_arg_t nt)
       {
-        boost::ptr_vector<std::thread> threads(mem_t::size());
-        for (int i = 0; i < this->algos.size(); ++i)
-        {
-          threads.push_back(new std::thread(
-            &solver_t::solve, &(this->algos[i]), nt
-          ));
-        }
-        for (auto &th : threads) th.join();
+        pool->run([this, nt](const int i) { this->algos[i].solve(nt); });
+      }
+
+      void run(const std::function<void(int)> &job)
+      {
+        pool->run(job);
       }
 
       // ctor
       cxx11_thread(const typename solver_t::rt_params_t &p) :
-        parent_t(p, new mem_t(p.grid_size), mem_t::size(p.grid_size[0]))
-      {}
+        parent_t(p, new mem_t(p.grid_size), mem_t::size(p.grid_size)),
+        pool(new detail::thread_pool(this->algos.size()))
+      {
+        // placing each thread's part of the shared arrays on its NUMA node
+        pool->run([this](const int i) { this->mem->first_touch(i); });
+        this->mem->numa_report();
+      }
 
     };
   } // namespace concurr
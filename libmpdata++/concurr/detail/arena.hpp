@@ -0,0 +1,138 @@
+/**
+ * @file
+ * @copyright University of Warsaw
+ * @section LICENSE
+ * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+#if defined(__linux__)
+#  include <sys/mman.h>
+#endif
+
+namespace libmpdataxx
+{
+  namespace concurr
+  {
+    namespace detail
+    {
+      // a bump allocator handing out cache-line aligned blocks from a few large regions
+      // (backed by transparent huge pages where available), with consecutive blocks
+      // staggered within a page so that arrays traversed in lockstep do not map onto
+      // the same cache sets; memory is released only when the arena is destroyed
+      class arena
+      {
+        enum { line = 64 };            // alignment of each block
+        enum { page = 4096 };          // period of cache-set aliasing
+        enum { n_stagger = 16 };       // number of distinct block offsets within a page
+        enum { huge_page = 2 << 20 };  // alignment of each region
+        enum { min_region = 64 << 20 }; // size of each region unless a larger block is requested
+
+        struct region_t
+        {
+          void *base;
+          std::size_t length;
+          std::uintptr_t frst, last, cursor;
+        };
+
+        std::vector<region_t> regions;
+        std::size_t n_blocks = 0, used = 0;
+
+        static std::uintptr_t align_up(const std::uintptr_t addr, const std::size_t alignment)
+        {
+          return (addr + alignment - 1) / alignment * alignment;
+        }
+
+        void add_region(const std::size_t size)
+        {
+          region_t r;
+          r.length = std::max(std::size_t(min_region), size + page + huge_page);
+#if defined(__linux__)
+          // untouched pages of the (over-)reserved region do not use physical memory
+          r.base = mmap(NULL, r.length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+          if (r.base == MAP_FAILED) throw std::bad_alloc();
+#else
+          r.base = std::malloc(r.length);
+          if (r.base == NULL) throw std::bad_alloc();
+#endif
+          r.frst = align_up(reinterpret_cast<std::uintptr_t>(r.base), huge_page);
+          r.last = reinterpret_cast<std::uintptr_t>(r.base) + r.length;
+          r.cursor = r.frst;
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+          madvise(reinterpret_cast<void*>(r.frst), (r.last - r.frst) / huge_page * huge_page, MADV_HUGEPAGE);
+#endif
+          regions.push_back(r);
+        }
+
+        public:
+
+        arena() = default;
+        arena(const arena&) = delete;
+        arena &operator=(const arena&) = delete;
+
+        ~arena()
+        {
+          for (auto &r : regions)
+          {
+#if defined(__linux__)
+            munmap(r.base, r.length);
+#else
+            std::free(r.base);
+#endif
+          }
+        }
+
+        void *allocate(const std::size_t size)
+        {
+          // placing the block at the next of n_stagger offsets within a page
+          const auto place = [this](const std::uintptr_t cursor)
+          {
+            const std::uintptr_t addr = align_up(cursor, line);
+            const std::uintptr_t offset = (n_blocks % n_stagger) * (page / n_stagger);
+            return addr - addr % page + offset + (addr % page > offset ? page : 0);
+          };
+
+          if (regions.empty() || place(regions.back().cursor) + size > regions.back().last)
+            add_region(size);
+
+          auto &r = regions.back();
+          const std::uintptr_t addr = place(r.cursor);
+          r.cursor = addr + size;
+          ++n_blocks;
+          used += size;
+          return reinterpret_cast<void*>(addr);
+        }
+
+        // bytes handed out (excluding padding)
+        std::size_t bytes_used() const
+        {
+          return used;
+        }
+
+        // bytes spanned by the handed-out blocks including padding
+        std::size_t bytes_spanned() const
+        {
+          std::size_t sum = 0;
+          for (auto &r : regions) sum += r.cursor - r.frst;
+          return sum;
+        }
+
+        // bytes of address space reserved
+        std::size_t bytes_reserved() const
+        {
+          std::size_t sum = 0;
+          for (auto &r : regions) sum += r.length;
+          return sum;
+        }
+      };
+    } // namespace detail
+  } // namespace concurr
+} // namespace libmpdataxx
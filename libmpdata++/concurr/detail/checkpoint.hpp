@@ -0,0 +1,117 @@
+/**
+ * @file
+ * @copyright University of Warsaw
+ * @section LICENSE
+ * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
+ */
+
+#pragma once
+
+#include <array>
+#include <vector>
+#include <string>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+
+namespace libmpdataxx
+{
+  namespace concurr
+  {
+    namespace detail
+    {
+      // scalars of the per-thread solver state saved in (or loaded from) a checkpoint;
+      // the same sequence of calls serves both purposes (see solver_common::state_io())
+      class state_io_t
+      {
+        std::vector<char> buf;
+        std::size_t pos = 0;
+
+        public:
+
+        const bool load;
+
+        explicit state_io_t(const bool load, const std::vector<char> &data = std::vector<char>()) :
+          buf(data),
+          load(load)
+        {}
+
+        template <typename T>
+        void operator()(T &val)
+        {
+          static_assert(std::is_trivially_copyable<T>::value, "only trivially copyable values can be checkpointed");
+          if (load)
+          {
+            if (pos + sizeof(T) > buf.size())
+              throw std::runtime_error("checkpoint: solver state shorter than expected");
+            std::memcpy(&val, buf.data() + pos, sizeof(T));
+          }
+          else
+          {
+            buf.resize(pos + sizeof(T));
+            std::memcpy(buf.data() + pos, &val, sizeof(T));
+          }
+          pos += sizeof(T);
+        }
+
+        template <typename T, std::size_t N>
+        void operator()(std::array<T, N> &vals)
+        {
+          for (auto &val : vals) (*this)(val);
+        }
+
+        template <typename T>
+        void operator()(std::vector<T> &vals)
+        {
+          std::size_t len = vals.size();
+          (*this)(len);
+          if (len != vals.size())
+            throw std::runtime_error("checkpoint: solver state of a different layout");
+          for (auto &val : vals) (*this)(val);
+        }
+
+        const std::vector<char> &data() const
+        {
+          return buf;
+        }
+
+        // true if all loaded data was consumed
+        bool complete() const
+        {
+          return pos == buf.size();
+        }
+      };
+
+      // fixed-size part of a checkpoint file, followed by the solver states and the arrays
+      struct checkpoint_header_t
+      {
+        char magic[16] = "libmpdata++ ckp";
+        int version = 1;
+        int real_size = 0;       // sizeof(real_t)
+        int n_dims = 0;
+        int size = 0;            // number of threads
+        int distmem_size = 0;    // number of MPI processes
+        int distmem_rank = 0;
+        std::array<int, 3> grid_size = {{0, 0, 0}};
+        long long n_arrays = 0;  // followed by the number of elements of each array
+        long long n_states = 0;  // followed by the length (in bytes) of each solver state
+
+        void check(const checkpoint_header_t &other) const
+        {
+          if (std::strncmp(magic, other.magic, sizeof(magic)) != 0 || version != other.version)
+            throw std::runtime_error("checkpoint: not a libmpdata++ checkpoint file");
+          if (
+            real_size != other.real_size ||
+            n_dims != other.n_dims ||
+            grid_size != other.grid_size
+          ) throw std::runtime_error("checkpoint: saved with a different floating-point type or grid");
+          if (
+            size != other.size ||
+            distmem_size != other.distmem_size ||
+            distmem_rank != other.distmem_rank
+          ) throw std::runtime_error("checkpoint: saved with a different number of threads or MPI processes");
+        }
+      };
+    } // namespace detail
+  } // namespace concurr
+} // namespace libmpdataxx
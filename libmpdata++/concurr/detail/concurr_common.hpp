@@ -16,6 +16,7 @@
 
 #include <libmpdata++/concurr/detail/sharedmem.hpp>
 #include <libmpdata++/concurr/detail/timer.hpp>
+#include <libmpdata++/concurr/detail/checkpoint.hpp>
 #include <libmpdata++/concurr/any.hpp>
 
 #include <libmpdata++/bcond/shared.hpp>
@@ -34,6 +35,10 @@
 #include <libmpdata++/bcond/remote_3d.hpp>
 #include <libmpdata++/bcond/gndsky_3d.hpp>
 
+#include <fstream>
+#include <functional>
+#include <type_traits>
+
 namespace libmpdataxx
 {
   namespace concurr
@@ -102,9 +107,21 @@ namespace libmpdataxx
           // allocate the memory to be shared by multiple threads
           mem.reset(mem_p);
           solver_t::alloc(mem.get(), p.n_iters);
+          solver_t::alloc_rt(mem.get(), p);
 
-          // allocate per-thread structures
-          init(p, mem->grid_size, size);
+          // allocate per-thread structures (thread ranks follow the row-major order of subdomains)
+          assert(size == mem->size);
+          init(p, mem->grid_size, mem->decomp);
+        }
+
+        /// @brief memory footprint of a run with the given parameters, computed without
+        ///        allocating the arrays (only one at a time) and without creating the solvers
+        static detail::footprint_t footprint_dry_run(const typename solver_t::rt_params_t &p)
+        {
+          mem_t mem(p.grid_size, 1, true);
+          solver_t::alloc(&mem, p.n_iters);
+          solver_t::alloc_rt(&mem, p);
+          return mem.footprint();
         }
 
         private:
@@ -115,7 +132,8 @@ namespace libmpdataxx
           int dim
         >
         void bc_set(
-          typename solver_t::bcp_t &bcp
+          typename solver_t::bcp_t &bcp,
+          const int thrd = 0 // position of the subdomain of the thread along dimension 0
         )
         {
           // sanity check - polar coords do not work with MPI yet
@@ -123,20 +141,34 @@ namespace libmpdataxx
             throw std::runtime_error("Polar boundary conditions do not work with MPI.");
 
           // distmem overrides
-          if (type != bcond::remote && mem->distmem.size() > 1 && dim == 0)
+          if (type != bcond::remote && mem->distmem.dims[dim] > 1)
           {
             if (
               // distmem domain interior
-              (dir == bcond::left && mem->distmem.rank() > 0)
+              (dir == bcond::left && mem->distmem.coords[dim] > 0)
               ||
-              (dir == bcond::rght && mem->distmem.rank() != mem->distmem.size() - 1)
+              (dir == bcond::rght && mem->distmem.coords[dim] != mem->distmem.dims[dim] - 1)
               // cyclic condition for distmem domain (note: will not work if a non-cyclic condition is on the other end)
               ||
               (type == bcond::cyclic)
-            ) return bc_set<bcond::remote, dir, dim>(bcp);
+            ) return bc_set<bcond::remote, dir, dim>(bcp, thrd);
           }
 
-          // bc allocation, all mpi routines called by the remote bcnd ctor are thread-safe (?)
+          bc_alloc<type, dir, dim>(bcp, thrd, std::integral_constant<bool, type == bcond::remote>());
+        }
+
+        // bc allocation, all mpi routines called by the remote bcnd ctor are thread-safe (?)
+        template <
+          bcond::bcond_e type,
+          bcond::drctn_e dir,
+          int dim
+        >
+        void bc_alloc(
+          typename solver_t::bcp_t &bcp,
+          const int,
+          std::false_type
+        )
+        {
           bcp.reset(
             new bcond::bcond<real_t, solver_t::halo, type, dir, solver_t::n_dims, dim>(
               mem->slab(mem->grid_size[dim]),
@@ -145,12 +177,41 @@ namespace libmpdataxx
           );
         }
 
+        // remote bconds are given the neighbouring process and a tag telling apart the messages
+        // exchanged with it: with the threads of each process splitting dimension 0 alone, in the
+        // other dimensions each thread at the edge of the subdomain exchanges halos with the thread
+        // at the same position in the neighbouring process
+        template <
+          bcond::bcond_e type,
+          bcond::drctn_e dir,
+          int dim
+        >
+        void bc_alloc(
+          typename solver_t::bcp_t &bcp,
+          const int thrd,
+          std::true_type
+        )
+        {
+          auto &dm = mem->distmem;
+          bcp.reset(
+            new bcond::bcond<real_t, solver_t::halo, type, dir, solver_t::n_dims, dim>(
+              mem->slab(mem->grid_size[dim]),
+              dm.grid_size,
+              dm.neighbour(dim, dir == bcond::left ? -1 : 1),
+              dir == bcond::left ? dm.coords[dim] == 0 : dm.coords[dim] == dm.dims[dim] - 1,
+              dim + solver_t::n_dims * (dim == 0 ? 0 : thrd)
+            )
+          );
+        }
+
         // 1D version
         void init(
           const typename solver_t::rt_params_t &p,
-          const std::array<rng_t, 1> &grid_size, const int &n0
+          const std::array<rng_t, 1> &grid_size,
+          const std::array<int, 1> &decomp
         )
         {
+          const int n0 = decomp[0];
           typename solver_t::bcp_t bxl, bxr, shrdl, shrdr;
 
           bc_set<bcxl, bcond::left, 0>(bxl);
@@ -181,31 +242,35 @@ namespace libmpdataxx
         void init(
           const typename solver_t::rt_params_t &p,
           const std::array<rng_t, 2> &grid_size,
-          const int &n0, const int &n1 = 1
+          const std::array<int, 2> &decomp
         ) {
+          const int n0 = decomp[0], n1 = decomp[1];
           for (int i0 = 0; i0 < n0; ++i0)
           {
             for (int i1 = 0; i1 < n1; ++i1)
             {
-              typename solver_t::bcp_t bxl, bxr, byl, byr, shrdl, shrdr;
+              typename solver_t::bcp_t bxl, bxr, byl, byr, shrdxl, shrdxr, shrdyl, shrdyr;
 
-              bc_set<bcxl, bcond::left, 0>(bxl);
-              bc_set<bcxr, bcond::rght, 0>(bxr);
+              bc_set<bcxl, bcond::left, 0>(bxl, i0);
+              bc_set<bcxr, bcond::rght, 0>(bxr, i0);
 
-              bc_set<bcyl, bcond::left, 1>(byl);
-              bc_set<bcyr, bcond::rght, 1>(byr);
+              bc_set<bcyl, bcond::left, 1>(byl, i0);
+              bc_set<bcyr, bcond::rght, 1>(byr, i0);
 
-              shrdl.reset(new bcond::shared<real_t, solver_t::halo, solver_t::n_dims>()); // TODO: shrdy if n1 != 1
-              shrdr.reset(new bcond::shared<real_t, solver_t::halo, solver_t::n_dims>()); // TODO: shrdy if n1 != 1
+              shrdxl.reset(new bcond::shared<real_t, solver_t::halo, solver_t::n_dims>());
+              shrdxr.reset(new bcond::shared<real_t, solver_t::halo, solver_t::n_dims>());
+              shrdyl.reset(new bcond::shared<real_t, solver_t::halo, solver_t::n_dims>());
+              shrdyr.reset(new bcond::shared<real_t, solver_t::halo, solver_t::n_dims>());
 
               algos.push_back(
                 new solver_t(
                   typename solver_t::ctor_args_t({
-                    i0,
+                    i0 * n1 + i1,
                     mem.get(),
-                    i0 == 0      ? bxl : shrdl,
-                    i0 == n0 - 1 ? bxr : shrdr,
-                    byl, byr,
+                    i0 == 0      ? bxl : shrdxl,
+                    i0 == n0 - 1 ? bxr : shrdxr,
+                    i1 == 0      ? byl : shrdyl,
+                    i1 == n1 - 1 ? byr : shrdyr,
                     mem->slab(grid_size[0], i0, n0),
                     mem->slab(grid_size[1], i1, n1)
                   }),
@@ -220,9 +285,10 @@ namespace libmpdataxx
         void init(
           const typename solver_t::rt_params_t &p,
           const std::array<rng_t, 3> &grid_size,
-          const int &n0, const int &n1 = 1, const int &n2 = 1
+          const std::array<int, 3> &decomp
         ) {
-          typename solver_t::bcp_t bxl, bxr, byl, byr, bzl, bzr, shrdl, shrdr;
+          const int n0 = decomp[0], n1 = decomp[1], n2 = decomp[2];
+          typename solver_t::bcp_t bxl, bxr, byl, byr, bzl, bzr, shrdxl, shrdxr, shrdyl, shrdyr, shrdzl, shrdzr;
 
           // TODO: renew pointers only if invalid ?
           for (int i0 = 0; i0 < n0; ++i0)
@@ -231,27 +297,33 @@ namespace libmpdataxx
             {
               for (int i2 = 0; i2 < n2; ++i2)
               {
-                bc_set<bcxl, bcond::left, 0>(bxl);
-                bc_set<bcxr, bcond::rght, 0>(bxr);
+                bc_set<bcxl, bcond::left, 0>(bxl, i0);
+                bc_set<bcxr, bcond::rght, 0>(bxr, i0);
 
-                bc_set<bcyl, bcond::left, 1>(byl);
-                bc_set<bcyr, bcond::rght, 1>(byr);
+                bc_set<bcyl, bcond::left, 1>(byl, i0);
+                bc_set<bcyr, bcond::rght, 1>(byr, i0);
 
-                bc_set<bczl, bcond::left, 2>(bzl);
-                bc_set<bczr, bcond::rght, 2>(bzr);
+                bc_set<bczl, bcond::left, 2>(bzl, i0);
+                bc_set<bczr, bcond::rght, 2>(bzr, i0);
 
-                shrdl.reset(new bcond::shared<real_t, solver_t::halo, solver_t::n_dims>()); // TODO: shrdy if n1 != 1
-                shrdr.reset(new bcond::shared<real_t, solver_t::halo, solver_t::n_dims>()); // TODO: shrdy if n1 != 1
+                shrdxl.reset(new bcond::shared<real_t, solver_t::halo, solver_t::n_dims>());
+                shrdxr.reset(new bcond::shared<real_t, solver_t::halo, solver_t::n_dims>());
+                shrdyl.reset(new bcond::shared<real_t, solver_t::halo, solver_t::n_dims>());
+                shrdyr.reset(new bcond::shared<real_t, solver_t::halo, solver_t::n_dims>());
+                shrdzl.reset(new bcond::shared<real_t, solver_t::halo, solver_t::n_dims>());
+                shrdzr.reset(new bcond::shared<real_t, solver_t::halo, solver_t::n_dims>());
 
                 algos.push_back(
                   new solver_t(
                     typename solver_t::ctor_args_t({
-                      i0,
+                      (i0 * n1 + i1) * n2 + i2,
                       mem.get(),
-                      i0 == 0      ? bxl : shrdl,
-                      i0 == n0 - 1 ? bxr : shrdr,
-                      byl, byr,
-                      bzl, bzr,
+                      i0 == 0      ? bxl : shrdxl,
+                      i0 == n0 - 1 ? bxr : shrdxr,
+                      i1 == 0      ? byl : shrdyl,
+                      i1 == n1 - 1 ? byr : shrdyr,
+                      i2 == 0      ? bzl : shrdzl,
+                      i2 == n2 - 1 ? bzr : shrdzr,
                       mem->slab(grid_size[0], i0, n0),
                       mem->slab(grid_size[1], i1, n1),
                       mem->slab(grid_size[2], i2, n2)
@@ -266,8 +338,152 @@ namespace libmpdataxx
 
         virtual void solve(advance_arg_t nt) = 0;
 
+        // calls job(rank) from each of the threads (with the same rank-to-thread mapping as solve())
+        virtual void run(const std::function<void(int)> &job) = 0;
+
+        std::string checkpoint_file(const std::string &path) const
+        {
+          return mem->distmem.size() == 1 ? path : path + "." + std::to_string(mem->distmem.rank());
+        }
+
+        detail::checkpoint_header_t checkpoint_header(const std::size_t n_arrays) const
+        {
+          detail::checkpoint_header_t hdr;
+          hdr.real_size = sizeof(real_t);
+          hdr.n_dims = solver_t::n_dims;
+          hdr.size = mem->size;
+          hdr.distmem_size = mem->distmem.size();
+          hdr.distmem_rank = mem->distmem.rank();
+          for (int d = 0; d < solver_t::n_dims; ++d) hdr.grid_size[d] = mem->distmem.grid_size[d];
+          hdr.n_arrays = n_arrays;
+          hdr.n_states = algos.size();
+          return hdr;
+        }
+
+        // each thread reads/writes an equal part of each array, the arrays stored one after another from offset on
+        void checkpoint_arrays_io(
+          const std::string &file,
+          const std::streamoff offset,
+          const std::vector<typename solver_t::arr_t*> &arrs,
+          const bool load
+        )
+        {
+          std::vector<char> failed(mem->size, false);
+          run([&](const int rank)
+          {
+            std::fstream fs(file, load ? std::ios::in | std::ios::binary : std::ios::in | std::ios::out | std::ios::binary);
+            std::streamoff pos = offset;
+            for (auto *arr : arrs)
+            {
+              const std::size_t n_elem = arr->numElements();
+              const std::size_t frst = n_elem * rank / mem->size, last = n_elem * (rank + 1) / mem->size;
+              char *ptr = reinterpret_cast<char*>(arr->dataFirst() + frst);
+              const std::streamsize len = (last - frst) * sizeof(real_t);
+              if (load)
+              {
+                fs.seekg(pos + std::streamoff(frst * sizeof(real_t)));
+                fs.read(ptr, len);
+              }
+              else
+              {
+                fs.seekp(pos + std::streamoff(frst * sizeof(real_t)));
+                fs.write(ptr, len);
+              }
+              pos += n_elem * sizeof(real_t);
+            }
+            failed[rank] = !fs;
+          });
+          if (std::find(failed.begin(), failed.end(), true) != failed.end())
+            throw std::runtime_error("checkpoint: failed to " + std::string(load ? "read " : "write ") + file);
+        }
+
         public:
 
+        void checkpoint(const std::string &path) final
+        {
+          const auto file = checkpoint_file(path);
+          const auto arrs = mem->checkpoint_arrays();
+
+          std::vector<long long> n_elems, state_lens;
+          std::size_t n_bytes = 0;
+          for (auto *arr : arrs)
+          {
+            if (!arr->isStorageContiguous())
+              throw std::runtime_error("checkpoint: non-contiguous shared array");
+            n_elems.push_back(arr->numElements());
+            n_bytes += arr->numElements() * sizeof(real_t);
+          }
+
+          std::vector<std::vector<char>> states;
+          for (auto &algo : algos)
+          {
+            detail::state_io_t io(false);
+            algo.state_io(io);
+            states.push_back(io.data());
+            state_lens.push_back(io.data().size());
+          }
+
+          std::streamoff offset;
+          {
+            std::ofstream ofs(file, std::ios::out | std::ios::trunc | std::ios::binary);
+            const auto hdr = checkpoint_header(arrs.size());
+            ofs.write(reinterpret_cast<const char*>(&hdr), sizeof(hdr));
+            ofs.write(reinterpret_cast<const char*>(n_elems.data()), n_elems.size() * sizeof(long long));
+            ofs.write(reinterpret_cast<const char*>(state_lens.data()), state_lens.size() * sizeof(long long));
+            ofs.write(reinterpret_cast<const char*>(&mem->n), sizeof(mem->n));
+            for (const auto &state : states) ofs.write(state.data(), state.size());
+            offset = ofs.tellp();
+
+            // setting the file size, so that the threads write to an existing file
+            if (n_bytes > 0)
+            {
+              ofs.seekp(offset + std::streamoff(n_bytes) - 1);
+              ofs.put(0);
+            }
+            if (!ofs) throw std::runtime_error("checkpoint: failed to write " + file);
+          }
+
+          checkpoint_arrays_io(file, offset, arrs, false);
+        }
+
+        void restart(const std::string &path) final
+        {
+          const auto file = checkpoint_file(path);
+          const auto arrs = mem->checkpoint_arrays();
+
+          std::ifstream ifs(file, std::ios::in | std::ios::binary);
+          if (!ifs) throw std::runtime_error("checkpoint: failed to open " + file);
+
+          detail::checkpoint_header_t hdr;
+          ifs.read(reinterpret_cast<char*>(&hdr), sizeof(hdr));
+          checkpoint_header(arrs.size()).check(hdr);
+
+          std::vector<long long> n_elems(hdr.n_arrays), state_lens(hdr.n_states);
+          ifs.read(reinterpret_cast<char*>(n_elems.data()), n_elems.size() * sizeof(long long));
+          ifs.read(reinterpret_cast<char*>(state_lens.data()), state_lens.size() * sizeof(long long));
+          if (!ifs || n_elems.size() != arrs.size())
+            throw std::runtime_error("checkpoint: saved with a different solver or parameters");
+          for (std::size_t i = 0; i < arrs.size(); ++i)
+            if (n_elems[i] != arrs[i]->numElements())
+              throw std::runtime_error("checkpoint: saved with a different solver or parameters");
+
+          ifs.read(reinterpret_cast<char*>(&mem->n), sizeof(mem->n));
+          for (std::size_t i = 0; i < algos.size(); ++i)
+          {
+            std::vector<char> state(state_lens[i]);
+            ifs.read(state.data(), state.size());
+            detail::state_io_t io(true, state);
+            algos[i].state_io(io);
+            if (!io.complete())
+              throw std::runtime_error("checkpoint: saved with a different solver or parameters");
+          }
+          if (!ifs) throw std::runtime_error("checkpoint: failed to read " + file);
+          const std::streamoff offset = ifs.tellg();
+          ifs.close();
+
+          checkpoint_arrays_io(file, offset, arrs, true);
+        }
+
         void advance(advance_arg_t nt) final
         {
           tmr.resume();
@@ -275,6 +491,11 @@ namespace libmpdataxx
           tmr.stop();
         }
 
+        detail::footprint_t footprint() final
+        {
+          return mem->footprint();
+        }
+
         typename solver_t::arr_t advectee(int e = 0) final
         {
           return mem->advectee(e);
@@ -323,6 +544,21 @@ namespace libmpdataxx
           return mem->sclr_array(name, n);
         }
 
+        typename solver_t::arr_t history(const std::string &name, int n = 0) final
+        {
+          return mem->history.at(name).slots[mem->history_slot(name, n)];
+        }
+
+        const real_t history_time(const std::string &name, int n = 0) final
+        {
+          return mem->history.at(name).times[mem->history_slot(name, n)];
+        }
+
+        int history_size(const std::string &name) final
+        {
+          return mem->history.count(name) ? mem->history.at(name).n_recs : 0;
+        }
+
         bool *panic_ptr() final
         {
           return &this->mem->panic;
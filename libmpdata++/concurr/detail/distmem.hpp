@@ -4,10 +4,14 @@
 #  include <boost/serialization/vector.hpp>
 #  include <boost/mpi/communicator.hpp>
 #  include <boost/mpi/collectives.hpp>
-#else
-#  include <cstdlib>
 #endif
 
+#include <array>
+#include <vector>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+
 
 namespace libmpdataxx
 {
@@ -44,11 +48,95 @@ public: // TODO: just a temp measure, make it private again
 #endif
         }
 
+        template <typename Op>
+        std::vector<double> reduce_vec_hlpr(const std::vector<double> &vals)
+        {
+#if defined(USE_MPI)
+          std::vector<double> res(vals.size());
+          boost::mpi::all_reduce(mpicom, vals.data(), vals.size(), res.data(), Op());
+          return res;
+#else
+          return vals;
+#endif
+        }
+
+
+        // number of dimensions split between processes (the outermost ones): at compile time with
+        // LIBMPDATAXX_MPI_DIMS defined or at run time with the LIBMPDATAXX_MPI_DIMS environment variable
+        // (the latter, if set, takes precedence); 1 by default, i.e. slabs along dimension 0
+        static int decomposed_dims()
+        {
+          const char *env_var = std::getenv("LIBMPDATAXX_MPI_DIMS");
+#if defined(LIBMPDATAXX_MPI_DIMS)
+          const int n = env_var != NULL ? std::atoi(env_var) : LIBMPDATAXX_MPI_DIMS;
+#else
+          const int n = env_var != NULL ? std::atoi(env_var) : 1;
+#endif
+          if (n < 1 || n > n_dims)
+            throw std::runtime_error("LIBMPDATAXX_MPI_DIMS has to be between 1 and the number of dimensions");
+          return n;
+        }
+
+        // the Cartesian process grid, see ctor
+        void init_cart()
+        {
+#if defined(USE_MPI)
+          dims.fill(1);
+          for (int d = 0; d < decomposed_dims(); ++d) dims[d] = 0;
+          MPI_Dims_create(size(), n_dims, dims.data());
+          for (int d = 0; d < n_dims; ++d)
+            if (dims[d] > grid_size[d])
+              throw std::runtime_error("number of processes along dimension " + std::to_string(d) + " greater than number of gridpoints");
+
+          // periodic in all dimensions, whether the domain is cyclic is up to the bconds;
+          // ranks not reordered, i.e. the same as in mpicom (and in row-major order of process coordinates)
+          std::array<int, n_dims> periods;
+          periods.fill(1);
+          MPI_Comm cart;
+          MPI_Cart_create(MPI_Comm(mpicom), n_dims, dims.data(), periods.data(), 0, &cart);
+          cartcom = boost::mpi::communicator(cart, boost::mpi::comm_take_ownership);
+          MPI_Cart_coords(MPI_Comm(cartcom), rank(), n_dims, coords.data());
+#else
+          dims.fill(1);
+          coords.fill(0);
+#endif
+        }
+
+#if defined(USE_MPI)
+        boost::mpi::communicator cartcom;
+#endif
 
         public:
 
         std::array<int, n_dims> grid_size;
 
+        // number of processes along each dimension and the position of this process
+        std::array<int, n_dims> dims, coords;
+
+        // rank of the process disp positions away along dimension d (with wrapping at the edges)
+        int neighbour(const int &d, const int &disp)
+        {
+#if defined(USE_MPI)
+          int src, dst;
+          MPI_Cart_shift(MPI_Comm(cartcom), d, disp, &src, &dst);
+          return dst;
+#else
+          return 0;
+#endif
+        }
+
+        // coordinates of the process of the given rank
+        std::array<int, n_dims> coords_of(const int &rank) const
+        {
+          std::array<int, n_dims> crds;
+          for (int d = n_dims - 1, r = rank; d >= 0; --d)
+          {
+            crds[d] = r % dims[d];
+            r /= dims[d];
+          }
+          return crds;
+        }
+
         int rank()
         {
 #if defined(USE_MPI)
@@ -101,6 +189,30 @@ public: // TODO: just a temp measure, make it private again
           return reduce_hlpr<std::plus<double>>(val);
         }
 
+        // element-wise reductions of vectors (in a single collective call)
+        std::vector<double> sum(const std::vector<double> &vals)
+        {
+          return reduce_vec_hlpr<std::plus<double>>(vals);
+        }
+
+        std::vector<double> min(const std::vector<double> &vals)
+        {
+#if defined(USE_MPI)
+          return reduce_vec_hlpr<boost::mpi::minimum<double>>(vals);
+#else
+          return vals;
+#endif
+        }
+
+        std::vector<double> max(const std::vector<double> &vals)
+        {
+#if defined(USE_MPI)
+          return reduce_vec_hlpr<boost::mpi::maximum<double>>(vals);
+#else
+          return vals;
+#endif
+        }
+
         // ctor
         distmem(const std::array<int, n_dims> &grid_size)
           : grid_size(grid_size)
@@ -131,6 +243,7 @@ public: // TODO: just a temp measure, make it private again
           }
           mpicom = boost::mpi::communicator(MPI_COMM_WORLD, boost::mpi::comm_duplicate); // use a duplicate of MPI_COMM_WORLD, can't construct it before MPI_Init call (?)
 #endif
+          init_cart();
         }
       };
     }
@@ -0,0 +1,84 @@
+/**
+ * @file
+ * @copyright University of Warsaw
+ * @section LICENSE
+ * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <ostream>
+#include <iomanip>
+#include <cstddef>
+
+namespace libmpdataxx
+{
+  namespace concurr
+  {
+    namespace detail
+    {
+      // breakdown of the memory held by the arrays shared between threads
+      struct footprint_t
+      {
+        struct entry_t
+        {
+          std::string owner;                      // member of sharedmem or the file of the layer owning the temporaries
+          std::vector<std::vector<int>> shapes;   // extents of each array (including halos)
+          std::size_t bytes = 0;                  // sum over the arrays
+        };
+
+        std::vector<entry_t> entries;
+
+        // sum over all entries (arrays sharing storage counted separately)
+        std::size_t bytes_arrays = 0;
+
+        // storage actually taken (arrays sharing storage counted once)
+        std::size_t bytes_allocated = 0;
+
+        void add(const std::string &owner, const std::vector<int> &shape, const std::size_t bytes)
+        {
+          if (entries.empty() || entries.back().owner != owner)
+          {
+            entries.push_back(entry_t());
+            entries.back().owner = owner;
+          }
+          entries.back().shapes.push_back(shape);
+          entries.back().bytes += bytes;
+          bytes_arrays += bytes;
+        }
+
+        void print(std::ostream &os) const
+        {
+          const double MiB = 1 << 20;
+          const auto flags = os.flags();
+          const auto prec = os.precision();
+          os << std::fixed << std::setprecision(1);
+          for (auto &e : entries)
+          {
+            os << std::setw(40) << std::left << e.owner << std::right
+               << std::setw(4) << e.shapes.size() << " x";
+            // listing each distinct shape once
+            std::vector<std::vector<int>> listed;
+            for (auto &s : e.shapes)
+            {
+              bool seen = false;
+              for (auto &l : listed) if (l == s) seen = true;
+              if (seen) continue;
+              listed.push_back(s);
+              os << " (";
+              for (std::size_t d = 0; d < s.size(); ++d) os << (d == 0 ? "" : ",") << s[d];
+              os << ")";
+            }
+            os << " " << e.bytes / MiB << " MiB" << std::endl;
+          }
+          os << "total: " << bytes_arrays / MiB << " MiB in arrays, "
+             << bytes_allocated / MiB << " MiB allocated" << std::endl;
+          os.flags(flags);
+          os.precision(prec);
+        }
+      };
+    } // namespace detail
+  } // namespace concurr
+} // namespace libmpdataxx
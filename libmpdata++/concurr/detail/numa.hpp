@@ -0,0 +1,75 @@
+/**
+ * @file
+ * @copyright University of Warsaw
+ * @section LICENSE
+ * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
+ */
+
+#pragma once
+
+#include <vector>
+#include <cstdlib> // std::getenv()
+
+#if defined(__linux__)
+#  include <unistd.h>
+#  include <sys/syscall.h>
+#endif
+
+namespace libmpdataxx
+{
+  namespace concurr
+  {
+    namespace detail
+    {
+      namespace numa
+      {
+        // true if the support for querying page placement is compiled in
+        constexpr bool available()
+        {
+#if defined(__linux__) && defined(SYS_move_pages) && defined(SYS_getcpu)
+          return true;
+#else
+          return false;
+#endif
+        }
+
+        // true if a placement report was requested with the LIBMPDATAXX_NUMA_REPORT environment variable
+        inline bool report_requested()
+        {
+          return std::getenv("LIBMPDATAXX_NUMA_REPORT") != NULL;
+        }
+
+        inline long page_size()
+        {
+#if defined(__linux__)
+          return sysconf(_SC_PAGESIZE);
+#else
+          return 4096;
+#endif
+        }
+
+        // NUMA node of the CPU the calling thread runs on (-1 if unknown)
+        inline int current_node()
+        {
+#if defined(__linux__) && defined(SYS_getcpu)
+          unsigned cpu, node;
+          if (syscall(SYS_getcpu, &cpu, &node, NULL) == 0) return node;
+#endif
+          return -1;
+        }
+
+        // NUMA nodes the given pages reside on (negative values for pages not yet faulted in or on error)
+        inline std::vector<int> page_nodes(std::vector<void*> &pages)
+        {
+          std::vector<int> status(pages.size(), -1);
+#if defined(__linux__) && defined(SYS_move_pages)
+          // with nodes == NULL move_pages() only queries the placement
+          if (!pages.empty() && syscall(SYS_move_pages, 0, pages.size(), pages.data(), NULL, status.data(), 0) != 0)
+            status.assign(pages.size(), -1);
+#endif
+          return status;
+        }
+      } // namespace numa
+    } // namespace detail
+  } // namespace concurr
+} // namespace libmpdataxx
@@ -12,9 +12,21 @@
 #include <libmpdata++/blitz.hpp>
 #include <libmpdata++/formulae/arakawa_c.hpp>
 #include <libmpdata++/concurr/detail/distmem.hpp>
+#include <libmpdata++/concurr/detail/numa.hpp>
+#include <libmpdata++/concurr/detail/arena.hpp>
+#include <libmpdata++/concurr/detail/footprint.hpp>
 
 #include <array>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <map>
 #include <numeric>
+#include <set>
+#include <stdexcept>
+#include <utility>
+#include <vector>
 
 namespace libmpdataxx
 {
@@ -35,7 +47,10 @@ namespace libmpdataxx
         static_assert(n_tlev > 0, "n_tlev <= 0");
 
         std::unique_ptr<blitz::Array<real_t, 1>> xtmtmp;
-        std::unique_ptr<blitz::Array<double, 1>> sumtmp;
+        std::unique_ptr<blitz::Array<double, 2>> sumtmp;
+
+        // per-thread outcome of first_touch() (see numa_report())
+        std::vector<std::pair<long, long>> numa_pages;
 
         protected:
 
@@ -46,6 +61,7 @@ namespace libmpdataxx
         int n = 0;
         const int size;
         std::array<rng_t, n_dims> grid_size;
+        std::array<int, n_dims> decomp; // number of thread subdomains in each dimension
         bool panic = false; // for multi-threaded SIGTERM handling
 
         detail::distmem<real_t, n_dims> distmem;
@@ -69,6 +85,40 @@ namespace libmpdataxx
           std::pair<const char*, int>
         > avail_tmp;
 
+        // byte buffers shared between threads, addressed by name (e.g. compressed output chunks)
+        std::unordered_map<
+          std::string,
+          std::vector<std::vector<char>>
+        > bufs;
+
+        // per-thread partial results of reductions, addressed by name (e.g. in-situ statistics of the output)
+        std::unordered_map<
+          std::string,
+          std::vector<std::vector<double>>
+        > partials;
+
+        // keys of tmp holding no state carried over between timesteps (skipped in checkpoints)
+        std::set<const char*> tmp_transient;
+
+        // records of the output variables kept in memory (see output::memory), addressed by name
+        struct history_t
+        {
+          std::vector<arr_t> slots;  // ring buffer, preallocated
+          std::vector<double> times; // time of the record in each slot
+          int n_recs = 0;            // number of records kept
+          int next = 0;              // slot to be written next
+        };
+        std::map<std::string, history_t> history;
+
+        // slot of the n-th most recent record (n = 0 for the latest)
+        int history_slot(const std::string &name, const int n) const
+        {
+          const auto &h = history.at(name);
+          if (n < 0 || n >= h.n_recs)
+            throw std::out_of_range("no record " + std::to_string(n) + " of " + name + " kept in memory");
+          return (h.next - 1 - n + int(h.slots.size())) % int(h.slots.size());
+        }
+
         virtual void barrier()
         {
           assert(false && "sharedmem_common::barrier() called!");
@@ -83,15 +133,16 @@ namespace libmpdataxx
 
         // ctors
         // TODO: fill reducetmp with NaNs (or use 1-element arrvec_t - it's NaN-filled by default)
-        sharedmem_common(const std::array<int, n_dims> &grid_size, const int &size)
-          : n(0), distmem(grid_size), size(size) // TODO: is n(0) needed?
+        // (with dry_run set, the arrays passed to old() are only accounted for in footprint())
+        sharedmem_common(const std::array<int, n_dims> &grid_size, const int &size, const bool dry_run = false)
+          : n(0), distmem(grid_size), size(size), dry_run(dry_run) // TODO: is n(0) needed?
         {
           for (int d = 0; d < n_dims; ++d)
           {
             this->grid_size[d] = slab(
               rng_t(0, grid_size[d]-1),
-              d == 0 ? distmem.rank() : 0,
-              d == 0 ? distmem.size() : 1
+              distmem.coords[d],
+              distmem.dims[d]
             );
             origin[d] = this->grid_size[d].first();
           }
@@ -100,12 +151,275 @@ namespace libmpdataxx
           oss << "grid_size[0]: " << this->grid_size[0] << " origin[0]: " << origin[0] << std::endl;
           std::cerr << oss.str() << std::endl;
 
-          if (size > grid_size[0])
-            throw std::runtime_error("number of subdomains greater than number of gridpoints");
+          if (distmem.size() > 1)
+          {
+            // the remote bconds of the threads of neighbouring processes have to match
+            // (see concurr_common::bc_set()), hence with MPI the threads of each process
+            // split dimension 0 alone
+            if (size > this->grid_size[0].length())
+              throw std::runtime_error("number of subdomains greater than number of gridpoints");
+            decomp.fill(1);
+            decomp[0] = size;
+          }
+          else
+          {
+            std::array<int, n_dims> gs;
+            for (int d = 0; d < n_dims; ++d) gs[d] = this->grid_size[d].length();
+            decomp = decompose(gs, size);
+          }
 
           if (n_dims != 1)
-            sumtmp.reset(new blitz::Array<double, 1>(this->grid_size[0]));
+            sumtmp.reset(new blitz::Array<double, 2>(this->grid_size[0], rng_t(0, size / decomp[0] - 1)));
           xtmtmp.reset(new blitz::Array<real_t, 1>(size));
+          numa_pages.resize(size);
+        }
+
+        /// @brief the largest number of threads that can be given a non-empty subdomain
+        static int max_size(const std::array<int, n_dims> &grid_size)
+        {
+#if defined(USE_MPI)
+          return grid_size[0];
+#else
+          return n_dims == 1 ? grid_size[0] : grid_size[0] * grid_size[1];
+#endif
+        }
+
+        /// @brief the largest number of threads not greater than size for which decompose()
+        ///        finds a layout fitting the grid (e.g. 5 and not 7 on a 5x5x5 grid)
+        static int fit_size(const std::array<int, n_dims> &grid_size, const int &size)
+        {
+#if defined(USE_MPI)
+          // threads split dimension 0 alone (see the ctor)
+          return std::min(size, grid_size[0]);
+#else
+          int n = size;
+          while (n > 1 && try_decompose(grid_size, n)[0] == 0) --n;
+          return n;
+#endif
+        }
+
+        /// @brief number of thread subdomains in each dimension chosen so that the total
+        ///        area of inter-thread boundaries is minimal; dimension 2 (the one contiguous
+        ///        in memory) is split only if size cannot be laid out on dimensions 0 and 1
+        static std::array<int, n_dims> decompose(const std::array<int, n_dims> &grid_size, const int &size)
+        {
+          const std::array<int, n_dims> best = try_decompose(grid_size, size);
+          if (best[0] == 0)
+            throw std::runtime_error("number of subdomains greater than number of gridpoints");
+          return best;
+        }
+
+        private:
+
+        // decompose() returning all zeros if no layout fits the grid
+        static std::array<int, n_dims> try_decompose(const std::array<int, n_dims> &grid_size, const int &size)
+        {
+          std::array<int, n_dims> best, cand;
+          best.fill(0);
+          std::pair<bool, double> best_cost(true, std::numeric_limits<double>::max());
+
+          for (int n0 = size; n0 >= 1; --n0)
+          {
+            if (size % n0 != 0) continue;
+            for (int n1 = size / n0; n1 >= 1; --n1)
+            {
+              if ((size / n0) % n1 != 0) continue;
+              cand.fill(1);
+              cand[0] = n0;
+              if (n_dims > 1) cand[n_dims > 1 ? 1 : 0] = n1;
+              if (n_dims > 2) cand[n_dims - 1] = size / n0 / n1;
+              if (std::accumulate(cand.begin(), cand.end(), 1, std::multiplies<int>()) != size) continue;
+
+              std::pair<bool, double> cost(n_dims > 2 && cand[n_dims - 1] > 1, 0);
+              bool fits = true;
+              for (int d = 0; d < n_dims; ++d)
+              {
+                if (cand[d] > grid_size[d]) fits = false;
+                double area = 1;
+                for (int dd = 0; dd < n_dims; ++dd) if (dd != d) area *= grid_size[dd];
+                cost.second += (cand[d] - 1) * area;
+              }
+              if (!fits) continue;
+
+              // strict inequality: ties resolved in favour of splitting outer dimensions
+              if (cost < best_cost)
+              {
+                best_cost = cost;
+                best = cand;
+              }
+            }
+          }
+
+          return best;
+        }
+
+        public:
+
+        /// @brief position of the subdomain of thread rank along dimension d
+        int thrd_crd(const int &rank, const int &d) const
+        {
+          int stride = 1;
+          for (int dd = n_dims - 1; dd > d; --dd) stride *= decomp[dd];
+          return (rank / stride) % decomp[d];
+        }
+
+        /// @brief range of dimension d covered by the subdomain of thread rank
+        rng_t subdomain(const int &rank, const int &d) const
+        {
+          return slab(grid_size[d], thrd_crd(rank, d), decomp[d]);
+        }
+
+        /// @brief all arrays shared between threads
+        std::vector<arr_t*> shared_arrays()
+        {
+          std::vector<arr_t*> arrs;
+          for (auto &psi_e : psi) for (auto &arr : psi_e) arrs.push_back(&arr);
+          for (auto *av : {&GC, &ndt_GC, &ndtt_GC, &vab_relax, &khn_tmp})
+            for (auto &arr : *av) arrs.push_back(&arr);
+          if (G) arrs.push_back(G.get());
+          if (vab_coeff) arrs.push_back(vab_coeff.get());
+          for (auto &tmp_file : tmp) for (auto &av : tmp_file.second) for (auto &arr : av) arrs.push_back(&arr);
+          return arrs;
+        }
+
+        /// @brief the arrays holding the state of the solvers, in an order not depending on the
+        ///        addresses of the keys of tmp (arrays sharing storage are listed only once as their
+        ///        contents are not carried over between timesteps)
+        std::vector<arr_t*> checkpoint_arrays()
+        {
+          std::vector<const char*> files;
+          for (auto &tmp_file : tmp)
+            if (tmp_transient.count(tmp_file.first) == 0) files.push_back(tmp_file.first);
+          std::sort(files.begin(), files.end(), [](const char *a, const char *b) { return std::strcmp(a, b) < 0; });
+
+          std::vector<arr_t*> arrs, uniq;
+          for (auto &psi_e : psi) for (auto &arr : psi_e) arrs.push_back(&arr);
+          for (auto *av : {&GC, &ndt_GC, &ndtt_GC, &vab_relax, &khn_tmp})
+            for (auto &arr : *av) arrs.push_back(&arr);
+          if (G) arrs.push_back(G.get());
+          if (vab_coeff) arrs.push_back(vab_coeff.get());
+          for (auto file : files) for (auto &av : tmp.at(file)) for (auto &arr : av) arrs.push_back(&arr);
+
+          std::vector<const real_t*> seen;
+          for (auto *arr : arrs)
+          {
+            if (std::find(seen.begin(), seen.end(), arr->dataFirst()) != seen.end()) continue;
+            seen.push_back(arr->dataFirst());
+            uniq.push_back(arr);
+          }
+          return uniq;
+        }
+
+        /// @brief part of arr belonging to the subdomain of thread rank
+        ///        (including halos at the edges of the domain, clipped to the extents of arr)
+        idx_t<n_dims> touch_idx(const int &rank, const arr_t &arr) const
+        {
+          idx_t<n_dims> idx;
+          for (int d = 0; d < n_dims; ++d)
+          {
+            const rng_t r = subdomain(rank, d);
+            const int crd = thrd_crd(rank, d);
+            idx.lbound(d) = crd == 0             ? arr.lbound(d) : std::max(r.first(), arr.lbound(d));
+            idx.ubound(d) = crd == decomp[d] - 1 ? arr.ubound(d) : std::min(r.last(),  arr.ubound(d));
+          }
+          return idx;
+        }
+
+        /// @brief calls f with the addresses of the first and the last element of each row
+        ///        (contiguous in memory) of the subdomain of thread rank in every shared array
+        template <class f_t>
+        void for_each_row(const int &rank, const f_t &f)
+        {
+          for (auto *arr : shared_arrays())
+          {
+            const auto idx = touch_idx(rank, *arr);
+            bool empty = false;
+            for (int d = 0; d < n_dims; ++d) empty = empty || idx.lbound(d) > idx.ubound(d);
+            if (empty) continue;
+
+            blitz::TinyVector<int, n_dims> pos = idx.lbound();
+            while (true)
+            {
+              auto frst = pos, last = pos;
+              last[n_dims - 1] = idx.ubound(n_dims - 1);
+              f(&(*arr)(frst), &(*arr)(last));
+
+              int d = n_dims - 2;
+              for (; d >= 0; --d)
+              {
+                if (++pos[d] <= idx.ubound(d)) break;
+                pos[d] = idx.lbound(d);
+              }
+              if (d < 0) break;
+            }
+          }
+        }
+
+        /// @brief touches the pages of the subdomain of thread rank in every shared array so that,
+        ///        with the first-touch policy of the OS, they land on the NUMA node of that thread;
+        ///        to be called from each thread with the same thread-to-rank mapping as used later
+        ///        in solve(); one element per page is read and written back, i.e. the values
+        ///        (e.g. set in the solvers' constructors) are preserved
+        void first_touch(const int &rank)
+        {
+          const std::uintptr_t page_size = numa::page_size();
+
+          for_each_row(rank, [page_size](real_t *frst, real_t *last)
+          {
+            for (
+              auto addr = reinterpret_cast<std::uintptr_t>(frst);
+              addr <= reinterpret_cast<std::uintptr_t>(last);
+              addr = (addr / page_size + 1) * page_size
+            )
+            {
+              // volatile so that the store of an unchanged value is not optimised away
+              volatile real_t *elem = reinterpret_cast<real_t*>(addr);
+              *elem = *elem;
+            }
+          });
+
+          if (numa::report_requested())
+            numa_pages.at(rank) = local_pages(rank);
+        }
+
+        /// @brief number of pages of the subdomain of thread rank that reside on the NUMA node
+        ///        the calling thread runs on, and the total number of the subdomain's pages
+        std::pair<long, long> local_pages(const int &rank)
+        {
+          const long page_size = numa::page_size();
+          std::vector<void*> pages;
+
+          for_each_row(rank, [page_size, &pages](real_t *frst, real_t *last)
+          {
+            for (
+              auto addr = reinterpret_cast<std::uintptr_t>(frst) / page_size * page_size;
+              addr <= reinterpret_cast<std::uintptr_t>(last);
+              addr += page_size
+            ) pages.push_back(reinterpret_cast<void*>(addr));
+          });
+
+          std::sort(pages.begin(), pages.end());
+          pages.erase(std::unique(pages.begin(), pages.end()), pages.end());
+
+          const int node = numa::current_node();
+          const auto nodes = numa::page_nodes(pages);
+          return std::make_pair(long(std::count(nodes.begin(), nodes.end(), node)), long(pages.size()));
+        }
+
+        /// @brief prints the outcome of first_touch() (to be called after all threads are done with it)
+        void numa_report() const
+        {
+          if (!numa::report_requested()) return;
+
+          std::ostringstream oss;
+          oss << "NUMA placement of shared arrays (pages on the thread's node / pages in the thread's subdomain):" << std::endl;
+          if (!numa::available())
+            oss << "  (page placement cannot be queried on this platform)" << std::endl;
+          else
+            for (int r = 0; r < size; ++r)
+              oss << "  thread " << r << ": " << numa_pages[r].first << " / " << numa_pages[r].second
+                  << " (" << (numa_pages[r].second > 0 ? 100. * numa_pages[r].first / numa_pages[r].second : 0.) << "%)" << std::endl;
+          std::cerr << oss.str();
         }
 
         /// @brief concurrency-aware summation of array elements
@@ -113,6 +427,8 @@ namespace libmpdataxx
         {
           // doing a two-step sum to reduce numerical error
           // and make parallel results reproducible
+          // (partial sums are stored per slice in dimension 0 and per thread column in the other dimensions)
+          const int col = rank % (size / decomp[0]);
           for (int c = ijk[0].first(); c <= ijk[0].last(); ++c) // TODO: optimise for i.count() == 1
           {
             auto slice_idx = ijk;
@@ -120,9 +436,9 @@ namespace libmpdataxx
             slice_idx.ubound(0) = c;
 
             if (sum_khn)
-              (*sumtmp)(c) = blitz::kahan_sum(arr(slice_idx));
+              (*sumtmp)(c, col) = blitz::kahan_sum(arr(slice_idx));
             else
-              (*sumtmp)(c) = blitz::sum(arr(slice_idx));
+              (*sumtmp)(c, col) = blitz::sum(arr(slice_idx));
           }
           barrier(); // wait for all threads to calc their part
 #if !defined(USE_MPI)
@@ -138,14 +454,14 @@ namespace libmpdataxx
           {
             // master thread calculates the sum from this process, stores in shared array
             if (sum_khn)
-              (*sumtmp)(grid_size[0].first())= blitz::kahan_sum(*sumtmp); // inplace?!
+              (*sumtmp)(grid_size[0].first(), 0)= blitz::kahan_sum(*sumtmp); // inplace?!
             else
-              (*sumtmp)(grid_size[0].first())= blitz::sum(*sumtmp); // inplace?!
+              (*sumtmp)(grid_size[0].first(), 0)= blitz::sum(*sumtmp); // inplace?!
             // master thread calculates sum of sums from all processes
-            (*sumtmp)(grid_size[0].first()) = this->distmem.sum((*sumtmp)(grid_size[0].first())); // inplace?!
+            (*sumtmp)(grid_size[0].first(), 0) = this->distmem.sum((*sumtmp)(grid_size[0].first(), 0)); // inplace?!
           }
           barrier();
-          double res = (*sumtmp)(grid_size[0].first()); // propagate the total sum to all threads of the process
+          double res = (*sumtmp)(grid_size[0].first(), 0); // propagate the total sum to all threads of the process
           barrier(); // to avoid sumtmp being overwritten by next call to sum from other thread
           return res;
 #endif
@@ -156,6 +472,7 @@ namespace libmpdataxx
         {
           // doing a two-step sum to reduce numerical error
           // and make parallel results reproducible
+          const int col = rank % (size / decomp[0]);
           for (int c = ijk[0].first(); c <= ijk[0].last(); ++c)
           {
             auto slice_idx = ijk;
@@ -163,9 +480,9 @@ namespace libmpdataxx
             slice_idx.ubound(0) = c;
 
             if (sum_khn)
-              (*sumtmp)(c) = blitz::kahan_sum(arr1(slice_idx) * arr2(slice_idx));
+              (*sumtmp)(c, col) = blitz::kahan_sum(arr1(slice_idx) * arr2(slice_idx));
             else
-              (*sumtmp)(c) = blitz::sum(arr1(slice_idx) * arr2(slice_idx));
+              (*sumtmp)(c, col) = blitz::sum(arr1(slice_idx) * arr2(slice_idx));
           }
           // TODO: code below same as in the function above
           barrier(); // wait for all threads to calc their part
@@ -182,14 +499,14 @@ namespace libmpdataxx
           {
             // master thread calculates the sum from this process, stores in shared array
             if (sum_khn)
-              (*sumtmp)(grid_size[0].first())= blitz::kahan_sum(*sumtmp); // inplace?!
+              (*sumtmp)(grid_size[0].first(), 0)= blitz::kahan_sum(*sumtmp); // inplace?!
             else
-              (*sumtmp)(grid_size[0].first())= blitz::sum(*sumtmp); // inplace?!
+              (*sumtmp)(grid_size[0].first(), 0)= blitz::sum(*sumtmp); // inplace?!
             // master thread calculates sum of sums from all processes
-            (*sumtmp)(grid_size[0].first()) = this->distmem.sum((*sumtmp)(grid_size[0].first())); // inplace?!
+            (*sumtmp)(grid_size[0].first(), 0) = this->distmem.sum((*sumtmp)(grid_size[0].first(), 0)); // inplace?!
           }
           barrier();
-          double res = (*sumtmp)(grid_size[0].first()); // propagate the total sum to all threads of the process
+          double res = (*sumtmp)(grid_size[0].first(), 0); // propagate the total sum to all threads of the process
           barrier(); // to avoid sumtmp being overwritten by next call to sum from other thread
           return res;
 #endif
@@ -264,9 +581,41 @@ namespace libmpdataxx
         // this hack is introduced to allow to use neverDeleteData
         // and hence to not use BZ_THREADSAFE
         private:
-        boost::ptr_vector<arr_t> tobefreed;
+        // backing storage of all arrays passed through old()
+        arena mem_arena;
+
+        // arena blocks shared by arrays live in disjoint phases of a timestep
+        struct slot_t
+        {
+          real_t *data;
+          std::size_t capacity;
+          int phases;
+        };
+        std::vector<slot_t> slots;
+
+        // in dry-run mode all arrays point to a scratch buffer fitting the largest of them
+        const bool dry_run;
+        std::vector<std::unique_ptr<real_t[]>> scratch;
+        std::size_t scratch_size = 0, dry_run_bytes = 0;
+
+        real_t *block(const std::size_t n)
+        {
+          if (!dry_run) return static_cast<real_t*>(mem_arena.allocate(n * sizeof(real_t)));
+
+          // earlier buffers are kept as the arrays pointing to them are never deallocated
+          if (n > scratch_size)
+          {
+            scratch.emplace_back(new real_t[n]);
+            scratch_size = n;
+          }
+          dry_run_bytes += n * sizeof(real_t);
+          return scratch.back().get();
+        }
 
         public:
+        // minimal size (in elements) of the blocks shared between phases (see old())
+        std::size_t tmp_slot_size = 0;
+
         arr_t *never_delete(arr_t *arg)
         {
           arr_t *ret = new arr_t(arg->dataFirst(), arg->shape(), blitz::neverDeleteData);
@@ -274,13 +623,82 @@ namespace libmpdataxx
           return ret;
         }
 
-        arr_t *old(arr_t *arg)
+        // takes ownership of a newly allocated array and returns an array of the same
+        // extents and base placed in the arena (the original storage is released);
+        // phase is a bitmask of the parts of a timestep in which the array is live -
+        // arrays with disjoint phases may end up sharing storage (-1 means always live)
+        arr_t *old(arr_t *arg, const int phase = -1)
         {
-          tobefreed.push_back(arg);
-          arr_t *ret = never_delete(arg);
+          std::unique_ptr<arr_t> orig(arg);
+          const std::size_t n = orig->numElements();
+          real_t *data = nullptr;
+
+          if (phase == -1)
+            data = block(n);
+          else
+          {
+            // first fit among the blocks not used in any of the array's phases
+            for (auto &slot : slots)
+            {
+              if ((slot.phases & phase) != 0 || slot.capacity < n) continue;
+              slot.phases |= phase;
+              data = slot.data;
+              break;
+            }
+            if (data == nullptr)
+            {
+              const std::size_t capacity = std::max(n, tmp_slot_size);
+              slots.push_back({block(capacity), capacity, phase});
+              data = slots.back().data;
+            }
+          }
+
+          arr_t *ret = new arr_t(data, orig->shape(), blitz::neverDeleteData);
+          ret->reindexSelf(orig->base());
           return ret;
         }
 
+        // bytes taken by arrays allocated in the arena (without and with alignment padding)
+        std::size_t arena_bytes_used() const { return mem_arena.bytes_used(); }
+        std::size_t arena_bytes_spanned() const { return mem_arena.bytes_spanned(); }
+
+        /// @brief memory taken by the shared arrays, grouped by the sharedmem member
+        ///        or (for temporary arrays) by the file of the solver layer they belong to
+        footprint_t footprint()
+        {
+          footprint_t fp;
+
+          const auto add = [&fp](const std::string &owner, const arr_t &arr)
+          {
+            std::vector<int> shape(n_dims);
+            for (int d = 0; d < n_dims; ++d) shape[d] = arr.extent(d);
+            fp.add(owner, shape, arr.numElements() * sizeof(real_t));
+          };
+
+          for (auto &psi_e : psi) for (auto &arr : psi_e) add("psi", arr);
+          for (auto &arr : GC) add("GC", arr);
+          for (auto &arr : ndt_GC) add("ndt_GC", arr);
+          for (auto &arr : ndtt_GC) add("ndtt_GC", arr);
+          if (G) add("G", *G);
+          if (vab_coeff) add("vab_coeff", *vab_coeff);
+          for (auto &arr : vab_relax) add("vab_relax", arr);
+          for (auto &arr : khn_tmp) add("khn_tmp", arr);
+
+          // the tmp map is unordered, sorting by the file name for a reproducible output
+          std::vector<std::pair<std::string, const boost::ptr_vector<arrvec_t<arr_t>>*>> files;
+          for (auto &tmp_file : tmp)
+          {
+            const std::string path(tmp_file.first);
+            files.emplace_back(path.substr(path.find_last_of('/') + 1), &tmp_file.second);
+          }
+          std::sort(files.begin(), files.end());
+          for (auto &file : files)
+            for (auto &av : *file.second) for (auto &arr : av) add(file.first, arr);
+
+          fp.bytes_allocated = dry_run ? dry_run_bytes : mem_arena.bytes_used();
+          return fp;
+        }
+
         private:
         // helper methods to define subdomain ranges
         static int min(const int &span, const int &rank, const int &size)
@@ -307,12 +725,76 @@ namespace libmpdataxx
 
         virtual arr_t advectee(int e = 0) = 0;
 
+        /// @brief range of dimension d covered by the subdomain of the process of the given rank
+        rng_t distmem_slab(const int &d, const int &rank)
+        {
+          return slab(rng_t(0, distmem.grid_size[d]-1), distmem.coords_of(rank)[d], distmem.dims[d]);
+        }
+
+        /// @brief part of the global domain covered by the subdomain of the process of the given rank
+        idx_t<n_dims> distmem_idx(const int &rank)
+        {
+          idx_t<n_dims> idx;
+          for (int d = 0; d < n_dims; ++d)
+          {
+            idx.lbound(d) = distmem_slab(d, rank).first();
+            idx.ubound(d) = distmem_slab(d, rank).last();
+          }
+          return idx;
+        }
+
+        const arr_t advectee_global(int e = 0)
+        {
+#if defined(USE_MPI)
+          if(this->distmem.size() > 1)
+          {
+            // a vector of number of elements to be sent by each process and their displacements
+            std::vector<int> sizes(this->distmem.size()), displ(this->distmem.size());
+            for (int r = 0; r < this->distmem.size(); ++r)
+            {
+              sizes[r] = 1;
+              for (int d = 0; d < n_dims; ++d) sizes[r] *= distmem_slab(d, r).length();
+              displ[r] = r == 0 ? 0 : displ[r-1] + sizes[r-1];
+            }
+            // a vector that will store the received data, relevant only on process rank=0
+            std::vector<real_t> out_values(displ.back() + sizes.back());
+            // create an array that will store advectee to be sent in a contiguous memory block
+            std::vector<real_t> in_values_vec(advectee(e).size());
+            std::copy(advectee(e).begin(), advectee(e).end(), in_values_vec.begin());
+
+            // gather the data from all processes on rank=0
+            boost::mpi::gatherv(this->distmem.mpicom, in_values_vec, out_values.data(), sizes, displ, 0);
+
+            // the subdomains (received one after another) put in place
+            blitz::TinyVector<int, n_dims> shape;
+            for (int d = 0; d < n_dims; ++d) shape[d] = this->distmem.grid_size[d];
+            arr_t res(shape);
+            if (this->distmem.rank() == 0)
+            {
+              for (int r = 0; r < this->distmem.size(); ++r)
+              {
+                const auto idx = distmem_idx(r);
+                blitz::TinyVector<int, n_dims> count;
+                for (int d = 0; d < n_dims; ++d) count[d] = idx.ubound(d) - idx.lbound(d) + 1;
+                res(idx) = arr_t(out_values.data() + displ[r], count, blitz::neverDeleteData);
+              }
+            }
+
+            // send the result to other processes
+            boost::mpi::broadcast(this->distmem.mpicom, res.data(), res.size(), 0);
+            return res;
+          }
+          else
+#endif
+            return advectee(e);
+        }
+
         void advectee_global_set(const arr_t arr, int e = 0)
         {
 #if defined(USE_MPI)
           if(this->distmem.size() > 1)
           {
-            advectee(e) = arr(slab(rng_t(0, distmem.grid_size[0]-1), distmem.rank(), distmem.size()));
+            advectee(e) = arr(distmem_idx(distmem.rank()));
           }
           else
 #endif
@@ -321,9 +803,17 @@ namespace libmpdataxx
 
         protected:
 
-        rng_t distmem_ext(const rng_t &rng)
+        // the advector is returned together with the vectors at the left edge of the subdomain (computed by this
+        // process, see remote bconds) in dimension 0 and in the other dimensions split between processes away
+        // from the left edge of the domain (in all its components, so that they can share the origin)
+        int distmem_ext(const int &d)
         {
-          return rng_t(rng.first()-1, rng.last());
+          return d == 0 || distmem.coords[d] > 0 ? 1 : 0;
+        }
+
+        rng_t distmem_ext(const int &d, const rng_t &rng)
+        {
+          return rng_t(rng.first() - distmem_ext(d), rng.last());
         }
 
       };
@@ -352,41 +842,6 @@ namespace libmpdataxx
           ).reindex(this->origin);
         }
 
-        const blitz::Array<real_t, 1> advectee_global(int e = 0)
-        {
-#if defined(USE_MPI)
-          if(this->distmem.size() > 1)
-          {
-// TODO: move some of that to distmem...
-// TODO: a lot of common code betwee 1,2 and 3 dimensions...
-
-            // a vector of number of elements to be sent by each non-root process
-            std::vector<int> sizes(this->distmem.size());
-            std::iota(sizes.begin(), sizes.end(), 0); // fill with 1,2,3,...
-            for(auto &size : sizes) { size = this->slab(rng_t(0, this->distmem.grid_size[0]-1), size, this->distmem.size()).length();}
-            // calc displacement
-            std::vector<int> displ(sizes.size());
-            std::partial_sum(sizes.begin(), sizes.end(), displ.begin());
-            std::transform(displ.begin(), displ.end(), sizes.begin(), displ.begin(), std::minus<int>()); // exclusive_scan is c++17
-            // a vector that will store the received data, relevant only on process rank=0
-            std::vector<real_t> out_values(this->distmem.grid_size[0]);
-            // create an array that will store advectee to be sent in a contiguous memory block
-            std::vector<real_t> in_values_vec(advectee(e).size());
-            std::copy(advectee(e).begin(), advectee(e).end(), in_values_vec.begin());
-
-            // gather the data from all processes on rank=0
-            boost::mpi::gatherv(this->distmem.mpicom, in_values_vec, out_values.data(), sizes, displ, 0);
-            // send the result to other processes
-            boost::mpi::broadcast(this->distmem.mpicom, out_values, 0);
-
-            blitz::Array<real_t, 1> res(out_values.data(), blitz::shape(this->distmem.grid_size[0]), blitz::duplicateData);
-            return res;
-          }
-          else
-#endif
-            return advectee(e);
-        }
-
         blitz::Array<real_t, 1> advector(int d = 0)
         {
           using namespace arakawa_c;
@@ -399,7 +854,7 @@ namespace libmpdataxx
                });
 
           return this->GC[d](
-            this->distmem_ext(this->grid_size[0]^(-1)^h)
+            this->distmem_ext(0, this->grid_size[0]^(-1)^h)
           ).reindex(
             this->distmem.rank() > 0
               ? decltype(this->origin)({this->origin[0] - 1})
@@ -455,47 +910,6 @@ namespace libmpdataxx
           ).reindex(this->origin);
         }
 
-        const blitz::Array<real_t, 2> advectee_global(int e = 0)
-        {
-#if defined(USE_MPI)
-          if(this->distmem.size() > 1)
-          {
-// TODO: move some of that to distmem...
-// TODO: a lot of common code betwee 1,2 and 3 dimensions...
-
-            // a vector of number of elements to be sent by each non-root process
-            std::vector<int> sizes(this->distmem.size());
-            std::iota(sizes.begin(), sizes.end(), 0); // fill with 1,2,3,...
-            for(auto &size : sizes)
-            {
-              size = this->slab(rng_t(0, this->distmem.grid_size[0]-1), size, this->distmem.size()).length()
-                      * this->grid_size[1].length();
-            }
-            // calc displacement
-            std::vector<int> displ(sizes.size());
-            std::partial_sum(sizes.begin(), sizes.end(), displ.begin());
-            std::transform(displ.begin(), displ.end(), sizes.begin(), displ.begin(), std::minus<int>()); // exclusive_scan is c++17
-            // a vector that will store the received data, relevant only on process rank=0
-            std::vector<real_t> out_values(this->distmem.grid_size[0] * this->grid_size[1].length());
-            // create an array that will store advectee to be sent in a contiguous memory block
-            std::vector<real_t> in_values_vec(advectee(e).size());
-            std::copy(advectee(e).begin(), advectee(e).end(), in_values_vec.begin());
-
-            // gather the data from all processes on rank=0
-            boost::mpi::gatherv(this->distmem.mpicom, in_values_vec, out_values.data(), sizes, displ, 0);
-            // send the result to other processes
-            boost::mpi::broadcast(this->distmem.mpicom, out_values, 0);
-
-            blitz::Array<real_t, 2> res(out_values.data(), blitz::shape(
-              this->distmem.grid_size[0], this->grid_size[1].length()),
-              blitz::duplicateData);
-            return res;
-          }
-          else
-#endif
-            return advectee(e);
-        }
-
         blitz::Array<real_t, 2> advector(int d = 0)
         {
           using namespace arakawa_c;
@@ -504,20 +918,20 @@ namespace libmpdataxx
           // reindexed to make it more intuitive when working with index placeholders
           auto orgn = decltype(this->origin)({
                  this->origin[0] - 1,
-                 this->origin[1]
+                 this->origin[1] - this->distmem_ext(1)
                });
 
           switch (d)
           {
             case 0:
               return this->GC[d](
-                this->distmem_ext(this->grid_size[0]^(-1)^h),
-                this->grid_size[1]
+                this->distmem_ext(0, this->grid_size[0]^(-1)^h),
+                this->distmem_ext(1, this->grid_size[1])
               ).reindex(orgn);
             case 1:
               return this->GC[d](
-                this->distmem_ext(this->grid_size[0]),
-                this->grid_size[1]^(-1)^h
+                this->distmem_ext(0, this->grid_size[0]),
+                this->distmem_ext(1, this->grid_size[1]^(-1)^h)
               ).reindex(orgn);
             default: assert(false); throw;
           }
@@ -590,47 +1004,6 @@ namespace libmpdataxx
           ).reindex(this->origin);
         }
 
-        const blitz::Array<real_t, 3> advectee_global(int e = 0)
-        {
-#if defined(USE_MPI)
-          if(this->distmem.size() > 1)
-          {
-// TODO: move some of that to distmem...
-// TODO: a lot of common code betwee 1,2 and 3 dimensions...
-
-            // a vector of number of elements to be sent by each non-root process
-            std::vector<int> sizes(this->distmem.size());
-            std::iota(sizes.begin(), sizes.end(), 0); // fill with 1,2,3,...
-            for(auto &size : sizes)
-            {
-              size = this->slab(rng_t(0, this->distmem.grid_size[0]-1), size, this->distmem.size()).length()
-                      * this->grid_size[1].length() * this->grid_size[2].length();
-            }
-            // calc displacement
-            std::vector<int> displ(sizes.size());
-            std::partial_sum(sizes.begin(), sizes.end(), displ.begin());
-            std::transform(displ.begin(), displ.end(), sizes.begin(), displ.begin(), std::minus<int>()); // exclusive_scan is c++17
-            // a vector that will store the received data, relevant only on process rank=0
-            std::vector<real_t> out_values(this->distmem.grid_size[0] * this->grid_size[1].length() * this->grid_size[2].length());
-            // create an array that will store advectee to be sent in a contiguous memory block
-            std::vector<real_t> in_values_vec(advectee(e).size());
-            std::copy(advectee(e).begin(), advectee(e).end(), in_values_vec.begin());
-
-            // gather the data from all processes on rank=0
-            boost::mpi::gatherv(this->distmem.mpicom, in_values_vec, out_values.data(), sizes, displ, 0);
-            // send the result to other processes
-            boost::mpi::broadcast(this->distmem.mpicom, out_values, 0);
-
-            blitz::Array<real_t, 3> res(out_values.data(), blitz::shape(
-              this->distmem.grid_size[0], this->grid_size[1].length(), this->grid_size[2].length()),
-              blitz::duplicateData);
-            return res;
-          }
-          else
-#endif
-            return advectee(e);
-        }
-
         blitz::Array<real_t, 3> advector(int d = 0)
         {
           using namespace arakawa_c;
@@ -639,29 +1012,29 @@ namespace libmpdataxx
           // reindexed to make it more intuitive when working with index placeholders
           auto orgn = decltype(this->origin)({
                  this->origin[0] - 1,
-                 this->origin[1],
-                 this->origin[2]
+                 this->origin[1] - this->distmem_ext(1),
+                 this->origin[2] - this->distmem_ext(2)
                });
 
           switch (d)
           {
             case 0:
               return this->GC[d](
-                this->distmem_ext(this->grid_size[0]^(-1)^h),
-                this->grid_size[1],
-                this->grid_size[2]
+                this->distmem_ext(0, this->grid_size[0]^(-1)^h),
+                this->distmem_ext(1, this->grid_size[1]),
+                this->distmem_ext(2, this->grid_size[2])
               ).reindex(orgn);
             case 1:
               return this->GC[d](
-                this->distmem_ext(this->grid_size[0]),
-                this->grid_size[1]^(-1)^h,
-                this->grid_size[2]
+                this->distmem_ext(0, this->grid_size[0]),
+                this->distmem_ext(1, this->grid_size[1]^(-1)^h),
+                this->distmem_ext(2, this->grid_size[2])
               ).reindex(orgn);
             case 2:
               return this->GC[d](
-                this->distmem_ext(this->grid_size[0]),
-                this->grid_size[1],
-                this->grid_size[2]^(-1)^h
+                this->distmem_ext(0, this->grid_size[0]),
+                this->distmem_ext(1, this->grid_size[1]),
+                this->distmem_ext(2, this->grid_size[2]^(-1)^h)
               ).reindex(orgn);
             default: assert(false); throw;
           }
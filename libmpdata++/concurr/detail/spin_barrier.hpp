@@ -0,0 +1,97 @@
+/**
+ * @file
+ * @copyright University of Warsaw
+ * @section LICENSE
+ * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
+ */
+
+#pragma once
+
+#include <atomic>
+#include <thread>
+#include <memory>
+#include <cstring>
+#include <cstdlib> // std::getenv()
+
+namespace libmpdataxx
+{
+  namespace concurr
+  {
+    namespace detail
+    {
+      // lock-free sense-reversing barrier: the last thread to arrive resets
+      // the counter and flips the shared sense, the others spin on it
+      // (yielding after spin_limit iterations to cope with oversubscription)
+      class spin_barrier
+      {
+        enum { spin_limit = 1024 };
+
+        const int m_threshold;
+        std::atomic<int> m_count;
+        char m_pad[64]; // keeping the counter and the sense on separate cache lines
+        std::atomic<bool> m_sense;
+
+        public:
+
+        explicit spin_barrier(const std::size_t count) :
+          m_threshold(count),
+          m_count(count),
+          m_sense(false)
+        { }
+
+        bool wait()
+        {
+          const bool sense = !m_sense.load(std::memory_order_relaxed);
+
+          if (m_count.fetch_sub(1, std::memory_order_acq_rel) == 1)
+          {
+            m_count.store(m_threshold, std::memory_order_relaxed);
+            m_sense.store(sense, std::memory_order_release);
+            return true;
+          }
+
+          for (int i = 0; m_sense.load(std::memory_order_acquire) != sense; ++i)
+            if (i >= spin_limit) std::this_thread::yield();
+          return false;
+        }
+      };
+
+      // true if the spin barrier was requested: at compile time with LIBMPDATAXX_SPIN_BARRIER
+      // defined or at run time with the LIBMPDATAXX_BARRIER environment variable set to "spin"
+      // (the latter, if set, takes precedence; "block" selects the blocking barrier)
+      inline bool spin_barrier_requested()
+      {
+        const char *env_var = std::getenv("LIBMPDATAXX_BARRIER");
+        if (env_var != NULL) return std::strcmp(env_var, "spin") == 0;
+#if defined(LIBMPDATAXX_SPIN_BARRIER)
+        return true;
+#else
+        return false;
+#endif
+      }
+
+      // either the spin barrier or a blocking one (mutex and condition variable based)
+      template <class blocking_barrier_t>
+      class selectable_barrier
+      {
+        std::unique_ptr<spin_barrier> spn;
+        std::unique_ptr<blocking_barrier_t> blk;
+
+        public:
+
+        explicit selectable_barrier(const std::size_t count, const bool spin = spin_barrier_requested())
+        {
+          if (spin)
+            spn.reset(new spin_barrier(count));
+          else
+            blk.reset(new blocking_barrier_t(count));
+        }
+
+        bool wait()
+        {
+          return spn ? spn->wait() : blk->wait();
+        }
+      };
+    };
+  } // namespace concurr
+} // namespace libmpdataxx
@@ -0,0 +1,149 @@
+/**
+ * @file
+ * @copyright University of Warsaw
+ * @section LICENSE
+ * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <vector>
+#include <string>
+#include <sstream>
+#include <iostream>
+#include <stdexcept>
+#include <cstdlib> // std::getenv()
+
+#if defined(__linux__)
+#  include <pthread.h>
+#  include <sched.h>
+#endif
+
+namespace libmpdataxx
+{
+  namespace concurr
+  {
+    namespace detail
+    {
+      // list of cores to pin the pool threads to, as requested with the LIBMPDATAXX_PIN_THREADS
+      // environment variable: unset or "0" - no pinning, "1" - thread r pinned to core r
+      // (modulo the number of cores), comma-separated list - thread r pinned to r-th core on the list
+      inline std::vector<int> pinning_requested()
+      {
+        std::vector<int> cores;
+        const char *env_var = std::getenv("LIBMPDATAXX_PIN_THREADS");
+        if (env_var == NULL) return cores;
+
+        const std::string val(env_var);
+        if (val == "0") return cores;
+        if (val == "1")
+        {
+          for (unsigned c = 0; c < std::max(1u, std::thread::hardware_concurrency()); ++c)
+            cores.push_back(c);
+          return cores;
+        }
+
+        std::istringstream iss(val);
+        std::string core;
+        while (std::getline(iss, core, ','))
+          cores.push_back(std::stoi(core));
+        if (cores.empty())
+          throw std::runtime_error("LIBMPDATAXX_PIN_THREADS: empty list of cores");
+        return cores;
+      }
+
+      // a set of threads that persist between calls to run() and are parked
+      // on a condition variable in between (instead of being created and
+      // joined each time, losing cache and NUMA affinity)
+      class thread_pool
+      {
+        std::vector<std::thread> workers;
+
+        std::mutex m_mutex;
+        std::condition_variable m_cond_start, m_cond_done;
+        std::function<void(int)> m_job;
+        std::size_t m_generation = 0;
+        int m_busy = 0;
+        bool m_stop = false;
+
+        void work(const int rank)
+        {
+          std::size_t gen = 0;
+          while (true)
+          {
+            {
+              std::unique_lock<std::mutex> lock(m_mutex);
+              while (!m_stop && m_generation == gen)
+                m_cond_start.wait(lock);
+              if (m_stop) return;
+              gen = m_generation;
+            }
+
+            m_job(rank);
+
+            {
+              std::unique_lock<std::mutex> lock(m_mutex);
+              if (--m_busy == 0) m_cond_done.notify_one();
+            }
+          }
+        }
+
+        static void pin(std::thread &th, const int core)
+        {
+#if defined(__linux__)
+          cpu_set_t cpuset;
+          CPU_ZERO(&cpuset);
+          CPU_SET(core, &cpuset);
+          if (pthread_setaffinity_np(th.native_handle(), sizeof(cpu_set_t), &cpuset) != 0)
+            std::cerr << "failed to pin thread to core " << core << std::endl;
+#endif
+        }
+
+        public:
+
+        // ctor
+        thread_pool(const int size, const std::vector<int> &cores = pinning_requested())
+        {
+          for (int r = 0; r < size; ++r)
+          {
+            workers.emplace_back(&thread_pool::work, this, r);
+            if (!cores.empty()) pin(workers.back(), cores[r % cores.size()]);
+          }
+        }
+
+        // dtor
+        ~thread_pool()
+        {
+          {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_stop = true;
+          }
+          m_cond_start.notify_all();
+          for (auto &th : workers) th.join();
+        }
+
+        int size() const
+        {
+          return workers.size();
+        }
+
+        // calls job(rank) on each of the pool threads and waits for all of them to finish
+        void run(const std::function<void(int)> &job)
+        {
+          std::unique_lock<std::mutex> lock(m_mutex);
+          m_job = job;
+          m_busy = workers.size();
+          ++m_generation;
+          m_cond_start.notify_all();
+          while (m_busy != 0)
+            m_cond_done.wait(lock);
+        }
+      };
+    };
+  } // namespace concurr
+} // namespace libmpdataxx
@@ -51,6 +51,12 @@ namespace libmpdataxx
 #endif
         }
 
+        // the number of threads requested, reduced to one that the grid can be decomposed into
+        static int size(const std::array<int, solver_t::n_dims> &grid_size)
+        {
+          return size(parent_t::mem_t::fit_size(grid_size, size(parent_t::mem_t::max_size(grid_size))));
+        }
+
         void barrier()
         {
           // TODO: if (size() != 1) ???
@@ -58,7 +64,7 @@ namespace libmpdataxx
         }
 
         // ctors
-        mem_t(const std::array<int, solver_t::n_dims> &grid_size) : parent_t::mem_t(grid_size, size(grid_size[0])) {};
+        mem_t(const std::array<int, solver_t::n_dims> &grid_size) : parent_t::mem_t(grid_size, size(grid_size)) {};
       };
 
       void solve(typename parent_t::advance_arg_t nt)
@@ -73,12 +79,36 @@ namespace libmpdataxx
         }
       }
 
+      void run(const std::function<void(int)> &job)
+      {
+        int i = 0;
+#pragma omp parallel private(i)
+        {
+#if defined(_OPENMP)
+          i = omp_get_thread_num();
+#endif
+          job(i);
+        }
+      }
+
       public:
 
       // ctor
       openmp(const typename solver_t::rt_params_t &p) :
-        parent_t(p, new mem_t(p.grid_size), mem_t::size(p.grid_size[0]))
-      {}
+        parent_t(p, new mem_t(p.grid_size), mem_t::size(p.grid_size))
+      {
+        // placing each thread's part of the shared arrays on its NUMA node
+        // (relies on the same thread numbering in subsequent parallel regions)
+        int i = 0;
+#pragma omp parallel private(i)
+        {
+#if defined(_OPENMP)
+          i = omp_get_thread_num();
+#endif
+          this->mem->first_touch(i);
+        }
+        this->mem->numa_report();
+      }
 
     };
   } // namespace concurr
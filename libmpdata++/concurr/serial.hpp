@@ -43,6 +43,11 @@ namespace libmpdataxx
         this->algos[0].solve(nt);
       }
 
+      void run(const std::function<void(int)> &job)
+      {
+        job(0);
+      }
+
       public:
 
       // ctor
@@ -94,6 +94,9 @@ namespace libmpdataxx
     enum { impl_tht = false};
     enum { sptl_intrp = 0}; // spatial interpolation of velocities
     enum { tmprl_extrp = 0}; // temporal extrapolation of velocities
+    enum { fused_advop = false}; // if true compute antidiffusive velocities, fluxes and donor-cell in a single cache-blocked pass (3D only)
+    enum { overlap_xchng = false}; // if true fill the halos of advectees while advecting the interior of the subdomain (3D only, no fct nor fused_advop)
+    enum { xchng_tracking = false}; // if true skip filling the halos of advectees that are still valid, requires hooks modifying advectees to call invalidate_halo() (see solver_common::xchng_tracked())
     enum { out_intrp_ord = 1};  // order of temporal interpolation for output
                                 // order > 1 is mostly useful for convergence tests as it can result
                                 // in negative field values
@@ -0,0 +1,121 @@
+/**
+ * @file
+ * @copyright University of Warsaw
+ * @section LICENSE
+ * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
+ */
+
+#pragma once
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <exception>
+#include <deque>
+
+namespace libmpdataxx
+{
+  namespace output
+  {
+    namespace detail
+    {
+      // a single background thread executing output jobs in the order of submission;
+      // an exception thrown from a job is rethrown from the next call to submit() or wait()
+      class async_writer
+      {
+        std::mutex m_mutex;
+        std::condition_variable m_cond;
+        std::deque<std::function<void()>> jobs;
+        int pending = 0; // queued or being executed
+        bool stop = false;
+        std::exception_ptr error;
+        std::thread worker;
+
+        void work()
+        {
+          while (true)
+          {
+            std::function<void()> job;
+            {
+              std::unique_lock<std::mutex> lock(m_mutex);
+              while (!stop && jobs.empty())
+                m_cond.wait(lock);
+              if (jobs.empty()) return; // jobs submitted before stopping are still executed
+              job = std::move(jobs.front());
+              jobs.pop_front();
+            }
+
+            try
+            {
+              job();
+            }
+            catch (...)
+            {
+              std::unique_lock<std::mutex> lock(m_mutex);
+              if (!error) error = std::current_exception();
+            }
+
+            {
+              std::unique_lock<std::mutex> lock(m_mutex);
+              --pending;
+            }
+            m_cond.notify_all();
+          }
+        }
+
+        void rethrow()
+        {
+          if (!error) return;
+          std::exception_ptr e;
+          std::swap(e, error);
+          std::rethrow_exception(e);
+        }
+
+        public:
+
+        // ctor
+        async_writer() :
+          worker(&async_writer::work, this)
+        {}
+
+        // dtor
+        ~async_writer()
+        {
+          {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            stop = true;
+          }
+          m_cond.notify_all();
+          worker.join();
+        }
+
+        void submit(std::function<void()> job)
+        {
+          {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            rethrow();
+            jobs.push_back(std::move(job));
+            ++pending;
+          }
+          m_cond.notify_all();
+        }
+
+        // true if called from within a job
+        bool in_worker() const
+        {
+          return std::this_thread::get_id() == worker.get_id();
+        }
+
+        // blocks until no more than max_pending jobs are queued or being executed
+        void wait(const int max_pending = 0)
+        {
+          std::unique_lock<std::mutex> lock(m_mutex);
+          while (pending > max_pending)
+            m_cond.wait(lock);
+          rethrow();
+        }
+      };
+    } // namespace detail
+  } // namespace output
+} // namespace libmpdataxx
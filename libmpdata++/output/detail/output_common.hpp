@@ -7,14 +7,33 @@
 
 #pragma once
 
+#include <libmpdata++/output/detail/async_writer.hpp>
+#include <libmpdata++/output/detail/stats.hpp>
+
 #include <map>
+#include <array>
 #include <vector>
+#include <memory>
 #include <functional>
+#include <algorithm>
+#include <stdexcept>
 
 namespace libmpdataxx
 {
   namespace output
   {
+    // compression of an output variable (used by the outputs supporting it, i.e. hdf5)
+    enum class codec_t
+    {
+      none,           // uncompressed
+      deflate,        // lossless
+      quantize,       // lossy: values rounded keeping the relative error below tolerance (bit grooming), then deflate
+      fixed_accuracy  // lossy: scale-offset filter keeping the absolute error below tolerance, then deflate
+    };
+
+    // floating-point type the output variable is stored as
+    enum class precision_t { float16, float32, float64 };
+
     namespace detail
     {
       template <class solver_t>
@@ -24,11 +43,100 @@ namespace libmpdataxx
 
         protected:
 
-        struct info_t { std::string name, unit; };
+        struct info_t
+        {
+          std::string name, unit;
+          bool pack = false; // compressed in parallel by all threads (if supported by the output)
+          codec_t codec = codec_t::deflate;
+          precision_t precision = precision_t::float32;
+          bool shuffle = false; // byte shuffling before compression (pays off with quantize)
+          double tolerance = 0; // error bound of the lossy codecs
+          // part of the domain recorded (if supported by the output): cells from roi_first to roi_last
+          // (inclusive, negative meaning the last cell) in each dimension, every stride-th cell
+          std::array<int, 3> roi_first = {{0, 0, 0}}, roi_last = {{-1, -1, -1}}, stride = {{1, 1, 1}};
+        };
         std::map<int, info_t> outvars;
 
+        // the recorded part of the domain in global cell indices
+        struct selection_t
+        {
+          blitz::TinyVector<int, parent_t::n_dims> first, stride, count;
+
+          bool full(const std::array<int, parent_t::n_dims> &grid_size) const
+          {
+            for (int d = 0; d < parent_t::n_dims; ++d)
+              if (first[d] != 0 || stride[d] != 1 || count[d] != grid_size[d]) return false;
+            return true;
+          }
+        };
+
+        selection_t selection(const info_t &info) const
+        {
+          selection_t sel;
+          for (int d = 0; d < parent_t::n_dims; ++d)
+          {
+            const int last = info.roi_last[d] < 0 ? this->mem->distmem.grid_size[d] - 1 : info.roi_last[d];
+            sel.first[d] = info.roi_first[d];
+            sel.stride[d] = info.stride[d];
+            sel.count[d] = (last - sel.first[d]) / sel.stride[d] + 1;
+          }
+          return sel;
+        }
+
+        // the part of a selection within the subdomain of this process: the cells from lo to hi
+        // with the given stride, located at offset in the selection (count is zero in some
+        // dimension if the subdomain does not intersect the selection)
+        struct local_selection_t
+        {
+          blitz::TinyVector<int, parent_t::n_dims> lo, hi, stride, count, offset;
+
+          bool empty() const
+          {
+            return blitz::product(count) == 0;
+          }
+
+          blitz::StridedDomain<parent_t::n_dims> domain() const
+          {
+            return blitz::StridedDomain<parent_t::n_dims>(lo, hi, stride);
+          }
+        };
+
+        local_selection_t local_selection(const selection_t &sel) const
+        {
+          blitz::TinyVector<int, parent_t::n_dims> lbound, ubound;
+          for (int d = 0; d < parent_t::n_dims; ++d)
+          {
+            lbound[d] = this->mem->grid_size[d].first();
+            ubound[d] = this->mem->grid_size[d].last();
+          }
+          return local_selection(sel, lbound, ubound);
+        }
+
+        // as above but within the given part of the domain (e.g. the subdomain of a thread)
+        local_selection_t local_selection(
+          const selection_t &sel,
+          const blitz::TinyVector<int, parent_t::n_dims> &lbound,
+          const blitz::TinyVector<int, parent_t::n_dims> &ubound
+        ) const
+        {
+          local_selection_t loc;
+          loc.stride = sel.stride;
+          for (int d = 0; d < parent_t::n_dims; ++d)
+          {
+            const int
+              first = std::max(sel.first[d], lbound[d]),
+              last = std::min(sel.first[d] + (sel.count[d] - 1) * sel.stride[d], ubound[d]);
+            loc.offset[d] = (first - sel.first[d] + sel.stride[d] - 1) / sel.stride[d];
+            loc.lo[d] = sel.first[d] + loc.offset[d] * sel.stride[d];
+            loc.count[d] = last < loc.lo[d] ? 0 : (last - loc.lo[d]) / sel.stride[d] + 1;
+            loc.hi[d] = loc.lo[d] + std::max(loc.count[d] - 1, 0) * sel.stride[d];
+          }
+          return loc;
+        }
+
         int do_record_cnt = 0;
-        typename parent_t::real_t record_time;
+        typename parent_t::real_t record_time, intrp_record_time = 0;
+        long long int record_timestep = 0; // timestep and time of the record being written
         const typename parent_t::advance_arg_t outfreq;
         const int outwindow;
         const std::string outdir;
@@ -36,14 +144,155 @@ namespace libmpdataxx
         arrvec_t<typename parent_t::arr_t> &intrp_vars;
         std::array<typename parent_t::real_t, parent_t::ct_params_t_::out_intrp_ord> intrp_times;
 
+        // asynchronous output: the fields are copied (by all threads) into one of n_stage
+        // staging buffers and written by a background thread while the computation continues
+        const bool out_async;
+        enum { n_stage = 2 };
+        int stage = 0;           // staging buffer to be filled next
+        int out_stage = -1;      // staging buffer being written (used by the writer thread only)
+        arrvec_t<typename parent_t::arr_t> *staging = nullptr;
+        std::unique_ptr<async_writer> writer; // rank 0 only
+
+        // in-situ statistics computed every statfreq timesteps
+        const std::vector<stat_info_t> out_stats;
+        const int statfreq;
+
         virtual void record(const int var) {}
         virtual void start(const typename parent_t::advance_arg_t nt) {}
 
-        typename parent_t::arr_t out_data(const int var)
+        // called from all threads before synchronous record_all() if pack_requested() (e.g. to compress the data in parallel)
+        virtual bool pack_requested() const { return false; }
+        virtual void pack_all() {}
+
+        // true for outputs reading the fields only through out_data() (required with out_async)
+        virtual bool out_async_supported() const { return false; }
+
+        // statistics (in the order of out_stats) at the given time, called by rank 0
+        // (from the writer thread with out_async)
+        virtual bool stats_supported() const { return false; }
+        virtual void record_stats(const double time, const std::vector<std::vector<double>> &vals) {}
+
+        typename parent_t::arr_t live_data(const int var)
         {
           return this->var_dt ? intrp_vars[var] : this->mem->advectee(var);
         }
 
+        typename parent_t::arr_t out_data(const int var)
+        {
+          return out_stage < 0 ? live_data(var) : (*staging)[out_stage * parent_t::n_eqns + var];
+        }
+
+        // waits for the records being written by the writer thread (with out_async); to be called
+        // before using anything record_all() uses, i.e. by the destructors of outputs before any such
+        // member is destroyed and by the auxiliary record methods called from hooks (a no-op if called
+        // from within record_all(), i.e. from the writer thread itself)
+        void out_flush()
+        {
+          if (writer && !writer->in_worker()) writer->wait();
+        }
+
+        // key of the staging arrays in mem->tmp (not part of the solver state)
+        static const char *staging_key()
+        {
+          return __FILE__ ":staging";
+        }
+
+        void init_async()
+        {
+          if (this->rank == 0 && !writer)
+          {
+            if (!out_async_supported())
+              throw std::runtime_error("out_async not supported by the chosen output");
+            writer.reset(new async_writer());
+          }
+          this->mem->barrier();
+          staging = &this->mem->tmp[staging_key()].back();
+        }
+
+        // key of the partial results of the statistics in mem->partials
+        static std::string stats_key()
+        {
+          return "output_common:stats";
+        }
+
+        void init_stats()
+        {
+          if (this->rank == 0 && this->mem->partials.count(stats_key()) == 0)
+          {
+            if (!stats_supported())
+              throw std::runtime_error("out_stats not supported by the chosen output");
+            this->mem->partials[stats_key()].resize(this->mem->size);
+          }
+          this->mem->barrier();
+        }
+
+        // each thread reduces over its subdomain, rank 0 combines the results
+        // of all threads (in a fixed order) and processes
+        void calc_stats()
+        {
+          const int n_lev = this->mem->distmem.grid_size[parent_t::n_dims - 1];
+          double n_cells_lev = 1;
+          for (int d = 0; d < parent_t::n_dims - 1; ++d) n_cells_lev *= this->mem->distmem.grid_size[d];
+
+          auto &parts = this->mem->partials.at(stats_key());
+          {
+            auto &part = parts[this->rank];
+            part.clear();
+            for (const auto &s : out_stats)
+            {
+              const auto len = stat_len(s, n_lev);
+              part.resize(part.size() + len, stat_init(s));
+              stat_partial<parent_t::n_dims>(
+                s, this->mem->advectee(s.var), this->mem->advectee(s.var2 < 0 ? s.var : s.var2), this->ijk, part.data() + part.size() - len
+              );
+            }
+          }
+          this->mem->barrier();
+
+          if (this->rank == 0)
+          {
+            std::vector<std::vector<double>> vals;
+            int pos = 0;
+            for (const auto &s : out_stats)
+            {
+              const auto len = stat_len(s, n_lev);
+              std::vector<double> res(len, stat_init(s));
+              for (const auto &part : parts) stat_combine(s, part.data() + pos, res.data(), len);
+              switch (stat_op(s))
+              {
+                case stat_op_t::min: res = this->mem->distmem.min(res); break;
+                case stat_op_t::max: res = this->mem->distmem.max(res); break;
+                default: res = this->mem->distmem.sum(res);
+              }
+              vals.push_back(stat_final(s, res, n_cells_lev));
+              pos += len;
+            }
+
+            const double time = this->time;
+            if (writer)
+              writer->submit([this, time, vals]() { record_stats(time, vals); });
+            else
+              record_stats(time, vals);
+          }
+          this->mem->barrier();
+        }
+
+        // continuing the output of a run restarted from a checkpoint (without recording the restored state)
+        void hook_restart(const typename parent_t::advance_arg_t nt)
+        {
+          parent_t::hook_restart(nt);
+
+          if (out_async) init_async();
+          if (!out_stats.empty()) init_stats();
+
+          if (this->rank == 0)
+          {
+            out_flush(); // records of the previous advance() may still be being written
+            start(nt);
+          }
+          this->mem->barrier();
+        }
+
         void hook_ante_loop(const typename parent_t::advance_arg_t nt)
         {
           parent_t::hook_ante_loop(nt);
@@ -55,13 +304,28 @@ namespace libmpdataxx
             this->mem->barrier();
           }
 
+          if (out_async) init_async();
+          if (!out_stats.empty()) init_stats();
+
           if (this->rank == 0)
           {
+            if (writer) writer->wait();
             record_time = this->time;
+            record_timestep = this->timestep;
             start(nt);
-            record_all();
           }
           this->mem->barrier();
+
+          if (pack_requested())
+          {
+            pack_all();
+            this->mem->barrier();
+          }
+
+          if (this->rank == 0) record_all();
+          this->mem->barrier();
+
+          if (!out_stats.empty()) calc_stats();
         }
 
         virtual void record_all()
@@ -90,7 +354,7 @@ namespace libmpdataxx
               if (do_record_cnt == 0)
               {
                 do_record_cnt = parent_t::ct_params_t_::out_intrp_ord;
-                record_time = next_idx * outfreq;
+                intrp_record_time = next_idx * outfreq;
               }
 
               int inc_ix = parent_t::ct_params_t_::out_intrp_ord - do_record_cnt;
@@ -117,7 +381,7 @@ namespace libmpdataxx
                   {
                     auto t0 = intrp_times[0];
                     auto t1 = this->time;
-                    auto t = record_time;
+                    auto t = intrp_record_time;
                     intrp_vars[v.first](this->ijk) *= (t1 - t) / (t1 - t0);
                     intrp_vars[v.first](this->ijk) += (t - t0) / (t1 - t0) *
                                                        this->mem->advectee(v.first)(this->ijk);
@@ -129,7 +393,7 @@ namespace libmpdataxx
                     auto t0 = intrp_times[0];
                     auto t1 = intrp_times[1];
                     auto t2 = this->time;
-                    auto t = record_time;
+                    auto t = intrp_record_time;
                     const auto & y0 = intrp_vars[v.first](this->ijk);
                     const auto & y1 = intrp_vars[v.first + parent_t::n_eqns](this->ijk);
                     const auto & y2 = this->mem->advectee(v.first)(this->ijk);
@@ -145,35 +409,94 @@ namespace libmpdataxx
               this->mem->barrier();
           }
 
-          if (this->rank == 0)
+          // number of records to be written in this timestep
+          int n_rec = 0;
+          if (this->var_dt && do_record_cnt == 1)
+          {
+            n_rec = 1;
+          }
+          else if (!this->var_dt)
           {
-            //TODO: output of solver statistics every timesteps could probably go here
+            for (int t = 0; t < outwindow; ++t)
+            {
+              if ((this->timestep - t) % static_cast<int>(outfreq) == 0) ++n_rec;
+            }
+          }
+          const auto rec_time = this->var_dt ? intrp_record_time : this->time;
+
+          if (out_async)
+          {
+            if (n_rec > 0)
+            {
+              // waiting for the staging buffer to be released by the writer
+              if (this->rank == 0) writer->wait(n_stage - 1);
+              this->mem->barrier();
+
+              for (const auto &v : outvars)
+                (*staging)[stage * parent_t::n_eqns + v.first](this->ijk) = live_data(v.first)(this->ijk);
+              this->mem->barrier();
 
-            if (this->var_dt && do_record_cnt == 1)
+              if (this->rank == 0)
+              {
+                const int stg = stage;
+                const auto rec_timestep = this->timestep;
+                writer->submit([this, stg, rec_time, rec_timestep, n_rec]()
+                {
+                  out_stage = stg;
+                  record_time = rec_time;
+                  record_timestep = rec_timestep;
+                  for (int r = 0; r < n_rec; ++r) record_all();
+                  out_stage = -1;
+                });
+              }
+              stage = (stage + 1) % n_stage;
+            }
+          }
+          else
+          {
+            if (n_rec > 0 && pack_requested())
             {
-              record_all();
+              pack_all();
+              this->mem->barrier();
             }
-            else if (!this->var_dt)
+
+            if (this->rank == 0)
             {
-              record_time = this->time;
-              for (int t = 0; t < outwindow; ++t)
+              if (n_rec > 0 || !this->var_dt)
               {
-                if ((this->timestep - t) % static_cast<int>(outfreq) == 0) record_all();
+                record_time = rec_time;
+                record_timestep = this->timestep;
               }
+              for (int r = 0; r < n_rec; ++r) record_all();
             }
           }
 
+          if (!out_stats.empty() && this->timestep % statfreq == 0) calc_stats();
+
           this->mem->barrier(); // waiting for the output to be finished
         }
 
         public:
 
+        void state_io(concurr::detail::state_io_t &io)
+        {
+          parent_t::state_io(io);
+          io(do_record_cnt);
+          io(record_time);
+          io(intrp_record_time);
+          io(record_timestep);
+          io(stage);
+        }
+
         struct rt_params_t : parent_t::rt_params_t
         {
           typename parent_t::advance_arg_t outfreq = 1;
           int outwindow = 1;
           std::map<int, info_t> outvars;
           std::string outdir;
+          bool out_async = false; // output written by a background thread (see output_common)
+          std::vector<stat_info_t> out_stats; // in-situ statistics (if supported by the output)
+          int statfreq = 1;                   // in timesteps
           // TODO: pass adiitional info? (command_line, library versions, ...)
         };
 
@@ -187,8 +510,31 @@ namespace libmpdataxx
           outwindow(p.outwindow),
           outvars(p.outvars),
           outdir(p.outdir),
-          intrp_vars(args.mem->tmp[__FILE__][0])
+          intrp_vars(args.mem->tmp[__FILE__][0]),
+          out_async(p.out_async),
+          out_stats(p.out_stats),
+          statfreq(p.statfreq)
         {
+          for (const auto &s : out_stats)
+          {
+            if (s.var < 0 || s.var >= parent_t::n_eqns || s.var2 >= parent_t::n_eqns)
+              throw std::runtime_error("out_stats: no such variable (" + s.name + ")");
+            if (s.type == stat_t::histogram && !(s.n_bins > 0 && s.hi > s.lo))
+              throw std::runtime_error("out_stats: invalid histogram bins (" + s.name + ")");
+          }
+          if (statfreq < 1)
+            throw std::runtime_error("statfreq must be positive");
+
+          for (const auto &v : outvars)
+          {
+            for (int d = 0; d < parent_t::n_dims; ++d)
+            {
+              const int n = args.mem->distmem.grid_size[d], last = v.second.roi_last[d] < 0 ? n - 1 : v.second.roi_last[d];
+              if (v.second.roi_first[d] < 0 || v.second.roi_first[d] > last || last >= n || v.second.stride[d] < 1)
+                throw std::runtime_error("invalid region of interest or stride of output variable " + v.second.name);
+            }
+          }
+
           // default value for outvars
           if (this->outvars.size() == 0 && parent_t::n_eqns == 1)
             outvars = {{0, {"", ""}}};
@@ -211,6 +557,18 @@ namespace libmpdataxx
           // TODO: only allocate for outvars !
           parent_t::alloc_tmp_sclr(mem, __FILE__, parent_t::ct_params_t_::out_intrp_ord * parent_t::n_eqns);
         }
+
+        static void alloc_rt(typename parent_t::mem_t *mem, const rt_params_t &p)
+        {
+          parent_t::alloc_rt(mem, p);
+          // staging buffers of the asynchronous output (allocated along with the other arrays
+          // to be placed in the arena and first-touched)
+          if (p.out_async)
+          {
+            parent_t::alloc_tmp_sclr(mem, staging_key(), n_stage * parent_t::n_eqns);
+            mem->tmp_transient.insert(staging_key());
+          }
+        }
       };
     } // namespace detail
   } // namespace output
@@ -0,0 +1,149 @@
+/**
+ * @file
+ * @copyright University of Warsaw
+ * @section LICENSE
+ * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
+ */
+
+#pragma once
+
+#include <libmpdata++/blitz.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace libmpdataxx
+{
+  namespace output
+  {
+    // in-situ statistics computed during the run and recorded as compact time series
+    // (levels being the planes of constant index in the last dimension)
+    enum class stat_t
+    {
+      level_mean,       // mean of var over each level
+      level_covariance, // covariance of var and var2 over each level (variance if var2 == var)
+      level_min,        // minimum of var over each level
+      level_max,        // maximum of var over each level
+      histogram         // number of cells with var in each of n_bins equal bins spanning [lo, hi)
+                        // (values outside counted in the outermost bins)
+    };
+
+    struct stat_info_t
+    {
+      std::string name; // of the recorded series
+      stat_t type;
+      int var, var2 = -1;
+      double lo = 0, hi = 1;
+      int n_bins = 10;
+    };
+
+    namespace detail
+    {
+      // reduction combining the partial results of a statistic across threads and processes
+      enum class stat_op_t { sum, min, max };
+
+      inline stat_op_t stat_op(const stat_info_t &s)
+      {
+        return s.type == stat_t::level_min ? stat_op_t::min :
+               s.type == stat_t::level_max ? stat_op_t::max :
+               stat_op_t::sum;
+      }
+
+      // length of the partial result of a statistic
+      inline int stat_len(const stat_info_t &s, const int n_lev)
+      {
+        return s.type == stat_t::histogram ? s.n_bins :
+               s.type == stat_t::level_covariance ? 3 * n_lev :
+               n_lev;
+      }
+
+      inline double stat_init(const stat_info_t &s)
+      {
+        return stat_op(s) == stat_op_t::min ?  std::numeric_limits<double>::infinity() :
+               stat_op(s) == stat_op_t::max ? -std::numeric_limits<double>::infinity() :
+               0;
+      }
+
+      inline void stat_combine(const stat_info_t &s, const double *part, double *res, const int len)
+      {
+        for (int i = 0; i < len; ++i)
+        {
+          switch (stat_op(s))
+          {
+            case stat_op_t::min: res[i] = std::min(res[i], part[i]); break;
+            case stat_op_t::max: res[i] = std::max(res[i], part[i]); break;
+            default: res[i] += part[i];
+          }
+        }
+      }
+
+      // partial result of a statistic over the ijk part of the domain (global level indices)
+      template <int n_dims, class arr_t>
+      void stat_partial(const stat_info_t &s, const arr_t &a, const arr_t &b, const idx_t<n_dims> &ijk, double *part)
+      {
+        if (s.type == stat_t::histogram)
+        {
+          const arr_t view = a(ijk);
+          for (auto it = view.begin(); it != view.end(); ++it)
+          {
+            if (std::isnan(*it)) continue;
+            const double bin = std::floor((*it - s.lo) / (s.hi - s.lo) * s.n_bins);
+            part[int(std::min(std::max(bin, 0.), s.n_bins - 1.))] += 1;
+          }
+          return;
+        }
+
+        for (int k = ijk.lbound(n_dims - 1); k <= ijk.ubound(n_dims - 1); ++k)
+        {
+          auto lev = ijk;
+          lev.lbound(n_dims - 1) = k;
+          lev.ubound(n_dims - 1) = k;
+
+          switch (s.type)
+          {
+            case stat_t::level_mean:
+              part[k] += blitz::sum(a(lev));
+              break;
+            case stat_t::level_covariance:
+              part[3 * k]     += blitz::sum(a(lev));
+              part[3 * k + 1] += blitz::sum(b(lev));
+              part[3 * k + 2] += blitz::sum(a(lev) * b(lev));
+              break;
+            case stat_t::level_min:
+              part[k] = std::min(part[k], double(blitz::min(a(lev))));
+              break;
+            case stat_t::level_max:
+              part[k] = std::max(part[k], double(blitz::max(a(lev))));
+              break;
+            default: assert(false);
+          }
+        }
+      }
+
+      // the statistic from the partial results combined over the whole domain
+      inline std::vector<double> stat_final(const stat_info_t &s, const std::vector<double> &res, const double n_cells_lev)
+      {
+        switch (s.type)
+        {
+          case stat_t::level_mean:
+          {
+            std::vector<double> mean(res);
+            for (auto &m : mean) m /= n_cells_lev;
+            return mean;
+          }
+          case stat_t::level_covariance:
+          {
+            std::vector<double> cov(res.size() / 3);
+            for (std::size_t k = 0; k < cov.size(); ++k)
+              cov[k] = res[3 * k + 2] / n_cells_lev - (res[3 * k] / n_cells_lev) * (res[3 * k + 1] / n_cells_lev);
+            return cov;
+          }
+          default: return res;
+        }
+      }
+    } // namespace detail
+  } // namespace output
+} // namespace libmpdataxx
@@ -6,6 +6,7 @@
 #include <set>
 #include <string>
 #include <sstream>
+#include <fstream>
 
 #include <boost/version.hpp>
 #include <boost/property_tree/ptree.hpp>
@@ -87,6 +88,38 @@ namespace libmpdataxx
             item.add(attr_node);
           }
 
+          // as above but for the given record of a series of records stored along the first dimension
+          void add(ptree& node, const int record)
+          {
+            ptree& attr_node = node.add("Attribute", "");
+            attr_node.put("<xmlattr>.Name", name);
+            attr_node.put("<xmlattr>.AttributeType", attribute_type);
+            attr_node.put("<xmlattr>.Center", center);
+
+            std::stringstream dims, slab;
+            for (auto d : item.dimensions) dims << d << ' ';
+            // start, stride and count in the record dimension followed by the spatial ones
+            slab << record << ' ';
+            for (int d = 0; d < dim; ++d) slab << "0 ";
+            slab << "1 ";
+            for (int d = 0; d < dim; ++d) slab << "1 ";
+            slab << "1 " << dims.str();
+
+            ptree& hs_node = attr_node.add("DataItem", "");
+            hs_node.put("<xmlattr>.ItemType", "HyperSlab");
+            hs_node.put("<xmlattr>.Dimensions", dims.str());
+            hs_node.put("<xmlattr>.Type", "HyperSlab");
+
+            ptree& sel_node = hs_node.add("DataItem", slab.str());
+            sel_node.put("<xmlattr>.Dimensions", "3 " + std::to_string(dim + 1));
+            sel_node.put("<xmlattr>.Format", "XML");
+
+            ptree& dat_node = hs_node.add("DataItem", item.data);
+            dat_node.put("<xmlattr>.Dimensions", std::to_string(record + 1) + ' ' + dims.str());
+            dat_node.put("<xmlattr>.NumberType", item.number_type);
+            dat_node.put("<xmlattr>.Format", item.format);
+          }
+
           // to allow storing attributes in std::set
           friend bool operator<(const attribute &lhs, const attribute &rhs)
           {
@@ -94,12 +127,26 @@ namespace libmpdataxx
           }
         };
 
+        // grid of a variable recorded on a part of the domain, with its own coordinates
+        struct subgrid
+        {
+          topology top;
+          geometry geo;
+          attribute attr;
+        };
+
         const std::string name = "Grid";
         const std::string grid_type = "Uniform";
         topology top;
         geometry geo;
         std::set<attribute> attrs;
         std::set<attribute> c_attrs;
+        std::vector<subgrid> subgrids;
+
+        // single-file time series markup, appended to in place
+        std::ofstream series;
+        std::streampos series_end;
+        const std::string series_footer = "\t\t</Grid>\n\t</Domain>\n</Xdmf>\n";
 
         attribute make_attribute(const std::string& name,
                                  const blitz::TinyVector<int, dim>& dimensions)
@@ -110,6 +157,51 @@ namespace libmpdataxx
           return a;
         }
 
+        // the grid (or, with subgrids, a spatial collection of grids) of a record,
+        // stored in hdf_name or, if record >= 0, in a series of records in hdf_name
+        void add_grids(ptree& grid_node, const std::string& hdf_name, const double time, const int record = -1)
+        {
+          for (auto& a : attrs)
+          {
+            a.item.data = hdf_name + ":/" + a.name;
+          }
+
+          grid_node.put("Time.<xmlattr>.Value", std::to_string(time));
+
+          ptree *main_node = &grid_node;
+          if (!subgrids.empty())
+          {
+            grid_node.put("<xmlattr>.Name", "Grids");
+            grid_node.put("<xmlattr>.GridType", "Collection");
+            grid_node.put("<xmlattr>.CollectionType", "Spatial");
+            main_node = &grid_node.add("Grid", "");
+          }
+          main_node->put("<xmlattr>.Name", name);
+          main_node->put("<xmlattr>.GridType", grid_type);
+
+          top.add(*main_node);
+
+          geo.add(*main_node);
+
+          for (auto a : attrs)
+            record < 0 ? a.add(*main_node) : a.add(*main_node, record);
+
+          for (auto ca : c_attrs)
+            ca.add(*main_node);
+
+          for (auto sg : subgrids)
+          {
+            sg.attr.item.data = hdf_name + ":/" + sg.attr.name;
+
+            ptree& sg_node = grid_node.add("Grid", "");
+            sg_node.put("<xmlattr>.Name", sg.attr.name);
+            sg_node.put("<xmlattr>.GridType", grid_type);
+            sg.top.add(sg_node);
+            sg.geo.add(sg_node);
+            record < 0 ? sg.attr.add(sg_node) : sg.attr.add(sg_node, record);
+          }
+        }
+
         public:
 
         void setup(const std::string& hdf_name,
@@ -141,6 +233,23 @@ namespace libmpdataxx
           attrs.insert(a);
         }
 
+        // a variable recorded on a part of the domain of the given dimensions (in cells),
+        // with the coordinates of the cell edges stored in hdf_name under coord_names
+        void add_subgrid(const std::string& name,
+                         const std::string& hdf_name,
+                         const std::map<int, std::string>& coord_names,
+                         const blitz::TinyVector<int, dim>& dimensions)
+        {
+          subgrid sg{topology(), geometry(), make_attribute(name, dimensions + 1)};
+          sg.top.dimensions = dimensions + 1;
+          for (const auto& cn : coord_names)
+          {
+            sg.geo.coords[cn.first].dimensions = dimensions + 1;
+            sg.geo.coords[cn.first].data = hdf_name + ":/" + cn.second;
+          }
+          subgrids.push_back(sg);
+        }
+
         void add_const_attribute(const std::string& name,
                                  const std::string& hdf_name,
                                  const blitz::TinyVector<int, dim>& dimensions)
@@ -153,27 +262,10 @@ namespace libmpdataxx
 
         void write(const std::string& xmf_name, const std::string& hdf_name, const double time)
         {
-          for (auto& a : attrs)
-          {
-            a.item.data = hdf_name + ":/" + a.name;
-          }
-
           ptree pt;
           ptree& grid_node = pt.put("Xdmf.Domain.Grid", "");
-          grid_node.put("<xmlattr>.Name", name);
-          grid_node.put("<xmlattr>.GridType", grid_type);
           grid_node.put("<xmlattr>.xml:id", "gid");
-          grid_node.put("Time.<xmlattr>.Value", std::to_string(time));
-
-          top.add(grid_node);
-
-          geo.add(grid_node);
-
-          for (auto a : attrs)
-            a.add(grid_node);
-
-          for (auto ca : c_attrs)
-            ca.add(grid_node);
+          add_grids(grid_node, hdf_name, time);
 
           xml_writer_settings settings('\t', 1);
           write_xml(xmf_name, pt, std::locale(), settings);
@@ -201,6 +293,50 @@ namespace libmpdataxx
           write_xml(xmf_name, pt, std::locale(), settings);
         }
 
+        // single temporal collection for records stored in a single file (see append_series())
+        // with append set, the grids are added to an existing collection (e.g. after a restart)
+        void open_series(const std::string& xmf_name, const bool append = false)
+        {
+          if (append)
+          {
+            series.open(xmf_name, std::ios::in | std::ios::out);
+            if (series.is_open())
+            {
+              series.seekp(0, std::ios::end);
+              series_end = series.tellp() - std::streamoff(series_footer.size());
+              return;
+            }
+            series.clear();
+          }
+
+          series.open(xmf_name, std::ios::out | std::ios::trunc);
+          series << "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n"
+                 << "<Xdmf Version=\"2.0\">\n"
+                 << "\t<Domain>\n"
+                 << "\t\t<Grid Name=\"TimeGrid\" GridType=\"Collection\" CollectionType=\"Temporal\">\n";
+          series_end = series.tellp();
+          series << series_footer << std::flush;
+        }
+
+        // adds the grid of the given record to the collection (overwriting the closing tags
+        // and writing them anew, so that the file is valid after each record, at O(1) cost)
+        void append_series(const std::string& hdf_name, const int record, const double time)
+        {
+          ptree pt;
+          ptree& grid_node = pt.add("Grid", "");
+          add_grids(grid_node, hdf_name, time, record);
+
+          std::ostringstream oss;
+          xml_writer_settings settings('\t', 1);
+          write_xml(oss, pt, settings);
+          // skipping the xml declaration
+          const std::string xml = oss.str();
+
+          series.seekp(series_end);
+          series << xml.substr(xml.find('\n') + 1);
+          series_end = series.tellp();
+          series << series_footer << std::flush;
+        }
       };
 
     }
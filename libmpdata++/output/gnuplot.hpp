@@ -15,6 +15,9 @@
 
 #include <boost/format.hpp>
 
+#include <vector>
+#include <sstream>
+
 namespace libmpdataxx
 {
   namespace output
@@ -34,6 +37,31 @@ namespace libmpdataxx
 
       std::unique_ptr<Gnuplot> gp;
       const int precision = 5;
+      std::vector<float> buf; // data sent with gnuplot_binary
+
+      // number of values sent per record of a 1D variable
+      int n_1d() const
+      {
+        return (p.gnuplot_command == "splot" ? 2 : 1) * this->mem->grid_size[0].length();
+      }
+
+      // data format of buf (see send_buf())
+      std::string buf_fmt() const
+      {
+        std::ostringstream fmt;
+        if (parent_t::n_dims == 1) // known at compile time
+          fmt << " binary record=(" << n_1d() << ") format='%float'";
+        else
+          fmt << " binary array=(" << this->mem->grid_size[0].length() << "," << this->mem->advectee(0).extent(1) << ") format='%float'";
+        return fmt.str();
+      }
+
+      // raw floats written to the pipe without text formatting
+      void send_buf()
+      {
+        gp->write(reinterpret_cast<const char*>(buf.data()), buf.size() * sizeof(float));
+        gp->flush();
+      }
 
       void start(const typename parent_t::advance_arg_t nt)
       {
@@ -103,6 +131,7 @@ namespace libmpdataxx
             for (const auto &v : this->outvars)
             {
               *gp << ", '-'";
+              if (p.gnuplot_binary) *gp << buf_fmt();
               if (p.gnuplot_command == "splot")
               {
                 *gp << " using (((int($0)+1)/2+(int($0)-1)/2)*.5";
@@ -162,7 +191,17 @@ namespace libmpdataxx
 
       void record(const int var)
       {
-        if (parent_t::n_dims == 1) // known at compile time
+        if (parent_t::n_dims == 1 && p.gnuplot_binary) // known at compile time
+        {
+          // values repeated twice if emulating histeps (see below)
+          const int rep = p.gnuplot_command == "splot" ? 2 : 1;
+          const auto psi = this->mem->advectee(var);
+          buf.resize(n_1d());
+          for (int i = 0; i < int(buf.size()); ++i)
+            buf[i] = psi(this->mem->grid_size[0].first() + i / rep);
+          send_buf();
+        }
+        else if (parent_t::n_dims == 1) // known at compile time
         {
           if (p.gnuplot_command == "splot")
           {
@@ -199,6 +238,34 @@ namespace libmpdataxx
             // ox = oy = 0;  // new: x =   i    * dx
             ox = this->mem->grid_size[0].first();
             oy = 0;
+
+            if (p.gnuplot_binary)
+            {
+              // sent as floats with x varying fastest (gnuplot's default scan order)
+              const auto psi = this->mem->advectee(var);
+              const int nx = this->mem->grid_size[0].length(), ny = psi.extent(1);
+              buf.resize(nx * ny);
+              for (int j = 0; j < ny; ++j)
+                for (int i = 0; i < nx; ++i)
+                  buf[j * nx + i] = psi(psi.lbound(0) + i, psi.lbound(1) + j);
+
+              if (imagebg)
+              {
+                float zmin, zmax;
+                int count = sscanf(p.gnuplot_zrange.c_str(), "[%g:%g]", &zmin, &zmax);
+                if (count != 2) zmin = 0;
+                *gp << " '-'" << buf_fmt()
+                    << " origin=(" << ox << "," << oy << "," << zmin << ")"
+                    << " with image failsafe notitle,";
+              }
+              *gp << " '-'" << buf_fmt()
+                  << " origin=(" << ox << "," << oy << ",0)"
+                  << " with " << p.gnuplot_with << " lt " << p.gnuplot_lt << " notitle\n";
+              send_buf();
+              if (imagebg) send_buf();
+              return;
+            }
+
             auto data = this->mem->advectee(var).copy();
             data.reindexSelf({0,0});
             if (imagebg)
@@ -260,6 +327,7 @@ namespace libmpdataxx
           gnuplot_palette = std::string(""),
           gnuplot_cbtics = std::string("");
         bool
+          gnuplot_binary = false, // data sent as raw floats (not rounded to the fixed precision used otherwise)
           gnuplot_contour = false,
           gnuplot_grid = true,
           gnuplot_surface = true;
@@ -22,10 +22,23 @@
 #  error "MPI enabled in libmpdata++ but not in HDF5"
 #endif
 
+// compression in parallel by the solver threads followed by direct chunk writes
+// (supported with serial HDF5 only, otherwise the packed variables are written as the others)
+#if !defined(USE_MPI) && defined(LIBMPDATAXX_HAVE_ZLIB) && defined(H5_HAVE_FILTER_DEFLATE)
+#  define LIBMPDATAXX_HDF5_PACK
+#  include <zlib.h>
+#  if !H5_VERSION_GE(1, 10, 3)
+#    include <H5DOpublic.h> // H5DOwrite_chunk() from the high-level library
+#  endif
+#endif
+
 #include <vector>
 #include <string>
 #include <sstream>
 #include <iomanip>
+#include <algorithm>
+#include <stdexcept>
+#include <cmath>
 namespace libmpdataxx
 {
   namespace output
@@ -45,6 +58,28 @@ namespace libmpdataxx
       std::string const_file;
       const hsize_t zero = 0, one = 1;
 
+      // single-file mode: each record appended along the first (unlimited) dimension of the datasets
+      const bool out_single_file;
+      const std::string series_name = "series.h5";
+      hsize_t n_records = 0;
+
+      const hsize_t out_alignment;
+
+      // in-situ statistics (see output_common), one record per computation
+      const std::string stats_name = "stats.h5";
+      std::unique_ptr<H5::H5File> statsp;
+      hsize_t n_stat_records = 0;
+
+      using info_t = typename parent_t::info_t;
+
+      // packing: chunks aligned with the thread decomposition, of the extents of the largest thread
+      // subdomain (i.e. with subdomains of equal size each chunk is the subdomain of one thread),
+      // each compressed by the thread which subdomain contains its first cell
+      blitz::TinyVector<hsize_t, parent_t::n_dims> pack_chunk;
+      blitz::TinyVector<int, parent_t::n_dims> n_pack_chunk; // number of chunks in each dimension
+      int n_pack_chunks = 0; // in total
+      bool packed = false; // true if pack_all() was called for the data to be recorded
+
       // HDF types of host data
       const H5::FloatType
         flttype_solver =
@@ -79,10 +114,25 @@ namespace libmpdataxx
           // creating the const file
 #if defined(USE_MPI)
           this->mem->distmem.barrier();
-          H5Pset_fapl_mpio(fapl_id, MPI_COMM_WORLD, MPI_INFO_NULL);
+          MPI_Info info = MPI_INFO_NULL;
+          if (out_alignment > 0)
+          {
+            // datasets aligned with (and MPI-IO told about) the stripes of the file system
+            MPI_Info_create(&info);
+            MPI_Info_set(info, "striping_unit", std::to_string(out_alignment).c_str());
+            H5Pset_alignment(fapl_id, out_alignment, out_alignment);
+          }
+          H5Pset_fapl_mpio(fapl_id, MPI_COMM_WORLD, info); // info is duplicated
+          if (info != MPI_INFO_NULL) MPI_Info_free(&info);
+#  if H5_VERSION_GE(1, 10, 0)
+          // metadata read and written collectively instead of by each process (reads) or by process 0 (writes)
+          H5Pset_all_coll_metadata_ops(fapl_id, true);
+          H5Pset_coll_metadata_write(fapl_id, true);
+#  endif
           H5Pset_dxpl_mpio(dxpl_id, H5FD_MPIO_COLLECTIVE);
 #endif
-          hdfp.reset(new H5::H5File(const_file, H5F_ACC_TRUNC
+          // after a restart from a checkpoint the file is reopened, keeping e.g. the record_aux_const() records
+          hdfp.reset(new H5::H5File(const_file, this->restarted ? H5F_ACC_RDWR : H5F_ACC_TRUNC
 #if defined(USE_MPI)
             , H5P_DEFAULT, fapl_id
 #endif
@@ -114,17 +164,28 @@ namespace libmpdataxx
 #if defined(USE_MPI)
           if (this->mem->distmem.size() > 1)
           {
-            shape[0] = this->mem->grid_size[0].length();
-            cshape[0] = this->mem->grid_size[0].length();
+            // hyperslabs of the subdomain of the process in each of the dimensions split between processes
+            for (int d = 0; d < parent_t::n_dims; ++d)
+            {
+              const auto &dm = this->mem->distmem;
+
+              shape[d] = this->mem->grid_size[d].length();
+              cshape[d] = this->mem->grid_size[d].length();
 
-            if (this->mem->distmem.rank() == this->mem->distmem.size() - 1)
-              cshape[0] += 1;
+              if (dm.coords[d] == dm.dims[d] - 1)
+                cshape[d] += 1;
 
-            offst[0] = this->mem->grid_size[0].first();
+              offst[d] = this->mem->grid_size[d].first();
 
-            // chunk size has to be common to all processes !
-            // TODO: something better ?
-            chunk[0] = ( (typename solver_t::real_t) (this->mem->distmem.grid_size[0])) / this->mem->distmem.size() + 0.5 ;
+              // chunk size has to be common to all processes, it is that of the largest subdomain,
+              // i.e. with subdomains of equal size each process writes whole chunks of its own
+              chunk[d] = 0;
+              for (int c = 0; c < dm.dims[d]; ++c)
+                chunk[d] = std::max<hsize_t>(
+                  chunk[d],
+                  this->mem->slab(rng_t(0, dm.grid_size[d] - 1), c, dm.dims[d]).length()
+                );
+            }
           }
 #endif
 
@@ -139,6 +200,20 @@ namespace libmpdataxx
           params.setDeflate(5); // TODO: move such constant to the header
 #endif
 
+          for (int d = 0; d < parent_t::n_dims; ++d)
+          {
+            pack_chunk[d] = 0;
+            for (int c = 0; c < this->mem->decomp[d]; ++c)
+              pack_chunk[d] = std::max<hsize_t>(
+                pack_chunk[d],
+                this->mem->slab(rng_t(0, shape[d] - 1), c, this->mem->decomp[d]).length()
+              );
+            n_pack_chunk[d] = (shape[d] + pack_chunk[d] - 1) / pack_chunk[d];
+          }
+          n_pack_chunks = blitz::product(n_pack_chunk);
+          for (const auto &v : this->outvars)
+            if (packable(v.second)) this->mem->bufs[pack_key(v.second.name)].resize(n_pack_chunks);
+
           // creating variables
           {
             // X, Y, Z
@@ -167,6 +242,8 @@ namespace libmpdataxx
                 default : break;
               }
 
+              if (this->restarted) continue; // already in the const file
+
               auto curr_dim = (*hdfp).createDataSet(name, flttype_output, cspace);
 
               H5::DataSpace dim_space = curr_dim.getSpace();
@@ -174,84 +251,541 @@ namespace libmpdataxx
               curr_dim.write(coord.data(), flttype_solver, H5::DataSpace(parent_t::n_dims, cshape.data()), dim_space, dxpl_id);
             }
 
-            // T
+            // the coordinates, G and the parameters are already in the const file after a restart
+            if (!this->restarted)
             {
-              const hsize_t
-                nt_out = nt / this->outfreq + 1; // incl. t=0
-              float dt = this->dt;
+              // X, Y, Z of the variables recorded on a part of the domain
+              for (const auto &v : this->outvars)
+              {
+                const auto sel = this->selection(v.second);
+                if (sel.full(this->mem->distmem.grid_size)) continue;
+
+                blitz::TinyVector<hsize_t, parent_t::n_dims> sel_cshape;
+                for (int d = 0; d < parent_t::n_dims; ++d) sel_cshape[d] = sel.count[d] + 1;
+
+                for (int i = 0; i < parent_t::n_dims; ++i)
+                {
+                  blitz::Array<typename solver_t::real_t, parent_t::n_dims> coord(sel_cshape);
+                  switch (i)
+                  {
+                    case 0 : coord = this->di * sel_edges(sel, i, blitz::firstIndex()); break;
+                    case 1 : coord = this->dj * sel_edges(sel, i, blitz::secondIndex()); break;
+                    case 2 : coord = this->dk * sel_edges(sel, i, blitz::thirdIndex()); break;
+                    default : break;
+                  }
+
+                  auto curr_dim = (*hdfp).createDataSet(sel_coord_name(dim_names[i], v.second.name), flttype_output, H5::DataSpace(parent_t::n_dims, sel_cshape.data()));
+
+                  // written by one process
+                  H5::DataSpace dim_space = curr_dim.getSpace(), mem_space(parent_t::n_dims, sel_cshape.data());
+                  if (this->mem->distmem.rank() != 0)
+                  {
+                    dim_space.selectNone();
+                    mem_space.selectNone();
+                  }
+                  curr_dim.write(coord.data(), flttype_solver, mem_space, dim_space, dxpl_id);
+                }
+              }
 
-              blitz::Array<typename solver_t::real_t, 1> coord(nt_out);
-              coord = (this->var_dt ? this->outfreq : this->outfreq * this->dt) * blitz::firstIndex();
+              // T
+              {
+                const hsize_t
+                  nt_out = nt / this->outfreq + 1; // incl. t=0
+                float dt = this->dt;
 
-              auto curr_dim = (*hdfp).createDataSet("T", flttype_output, H5::DataSpace(1, &nt_out));
+                blitz::Array<typename solver_t::real_t, 1> coord(nt_out);
+                coord = (this->var_dt ? this->outfreq : this->outfreq * this->dt) * blitz::firstIndex();
 
-              H5::DataSpace dim_space = curr_dim.getSpace();
-              dim_space.selectHyperslab(H5S_SELECT_SET, &nt_out, &zero);
-              curr_dim.write(coord.data(), flttype_solver, H5::DataSpace(1, &nt_out), dim_space, dxpl_id);
-            }
+                auto curr_dim = (*hdfp).createDataSet("T", flttype_output, H5::DataSpace(1, &nt_out));
 
-            // G factor
-            if (this->mem->G.get() != nullptr)
-            {
-              auto g_set = (*hdfp).createDataSet("G", flttype_output, sspace);
-              record_dsc_helper(g_set, *this->mem->G);
-            }
+                H5::DataSpace dim_space = curr_dim.getSpace();
+                dim_space.selectHyperslab(H5S_SELECT_SET, &nt_out, &zero);
+                curr_dim.write(coord.data(), flttype_solver, H5::DataSpace(1, &nt_out), dim_space, dxpl_id);
+              }
 
-            // save selected compile and runtime parameters, the choice depends on the solver family
-            record_params(*hdfp, typename parent_t::solver_family{});
+              // G factor
+              if (this->mem->G.get() != nullptr)
+              {
+                auto g_set = (*hdfp).createDataSet("G", flttype_output, sspace);
+                record_dsc_helper(g_set, *this->mem->G);
+              }
+
+              // save selected compile and runtime parameters, the choice depends on the solver family
+              record_params(*hdfp, typename parent_t::solver_family{});
+            }
           }
         }
+
+        if (out_single_file)
+        {
+          // after a restart from a checkpoint the records are appended to the existing series
+          hdfp.reset(new H5::H5File(this->outdir + "/" + series_name, this->restarted ? H5F_ACC_RDWR : H5F_ACC_TRUNC
+#if defined(USE_MPI)
+            , H5P_DEFAULT, fapl_id
+#endif
+          ));
+          if (!this->restarted) n_records = 0;
+        }
+
+        if (!this->out_stats.empty())
+        {
+          statsp.reset(new H5::H5File(this->outdir + "/" + stats_name, this->restarted ? H5F_ACC_RDWR : H5F_ACC_TRUNC
+#if defined(USE_MPI)
+            , H5P_DEFAULT, fapl_id
+#endif
+          ));
+          if (!this->restarted) n_stat_records = 0;
+        }
       }
 
       std::string base_name()
       {
         std::stringstream ss;
-        ss << "timestep" << std::setw(10) << std::setfill('0') << this->timestep;
+        ss << "timestep" << std::setw(10) << std::setfill('0') << this->record_timestep;
         return ss.str();
       }
 
       std::string hdf_name()
       {
         // TODO: add option of .nc extension for Paraview sake ?
-        return base_name() + ".h5";
+        return out_single_file ? series_name : base_name() + ".h5";
+      }
+
+      // single-file mode: dataset of records of the extents of gspace (scalar records for
+      // a scalar gspace), created on first use and extended to hold the current record;
+      // array records are chunked so that each of them is stored (and can be read) separately
+      template <class hdf_t>
+      H5::DataSet series_dset(const hdf_t &hdf, const std::string &name, const H5::DataSpace &gspace, const hsize_t *gchunk = nullptr, const info_t &info = info_t())
+      {
+        return series_dset(hdf, n_records, name, gspace, gchunk, info);
+      }
+
+      // as above with n_recs records
+      template <class hdf_t>
+      H5::DataSet series_dset(const hdf_t &hdf, const hsize_t n_recs, const std::string &name, const H5::DataSpace &gspace, const hsize_t *gchunk, const info_t &info)
+      {
+        const int rank = gspace.getSimpleExtentNdims();
+        std::vector<hsize_t> dims(rank + 1), maxdims(rank + 1), chnk(rank + 1);
+        if (rank > 0) gspace.getSimpleExtentDims(dims.data() + 1);
+        dims[0] = n_recs;
+        maxdims = dims;
+        maxdims[0] = H5S_UNLIMITED;
+        chnk[0] = rank > 0 ? 1 : 1024;
+        if (rank > 0) std::copy(gchunk, gchunk + rank, chnk.begin() + 1);
+
+        if (H5Lexists(hdf.getId(), name.c_str(), H5P_DEFAULT) > 0)
+        {
+          H5::DataSet dset = hdf.openDataSet(name);
+          dset.extend(dims.data());
+          return dset;
+        }
+
+        return hdf.createDataSet(name, file_type(info), H5::DataSpace(rank + 1, dims.data(), maxdims.data()), var_params(rank + 1, chnk.data(), info));
+      }
+
+      // name of the coordinate of the cell edges of a variable recorded on a part of the domain
+      static std::string sel_coord_name(const std::string &dim_name, const std::string &var_name)
+      {
+        return dim_name + "_" + var_name;
       }
 
+      // index of the cell edges of a selection along dimension d, the cells of a strided selection
+      // extending up to the next selected cell (or to the end of the selection)
+      template <class index_t>
+      static auto sel_edges(const typename parent_t::selection_t &sel, const int d, const index_t &idx)
+      {
+        const int end = sel.first[d] + (sel.count[d] - 1) * sel.stride[d] + 1;
+        return blitz::where(sel.first[d] + sel.stride[d] * idx < end, sel.first[d] + sel.stride[d] * idx, end);
+      }
+
+      // type of the dataset of an output variable
+      static H5::FloatType file_type(const info_t &info)
+      {
+        switch (info.precision)
+        {
+          case precision_t::float16:
+          {
+            // IEEE 754 half precision (not predefined in HDF5 before 1.14.4)
+            H5::FloatType type(H5::PredType::IEEE_F32LE);
+            type.setFields(15, 10, 5, 0, 10);
+            type.setSize(2);
+            type.setEbias(15);
+            return type;
+          }
+          case precision_t::float64: return H5::PredType::NATIVE_DOUBLE;
+          default: return H5::PredType::NATIVE_FLOAT;
+        }
+      }
+
+      // creation properties of the (chunked) dataset of an output variable
+      // (filters are not used with MPI, the lossy quantize codec is applied to the data and works regardless)
+      static H5::DSetCreatPropList var_params(const int rank, const hsize_t *chnk, const info_t &info)
+      {
+        H5::DSetCreatPropList prms;
+        prms.setChunk(rank, chnk);
+#if !defined(USE_MPI)
+        if (info.codec == codec_t::fixed_accuracy)
+        {
+          // values stored as integers scaled by 10^D, i.e. with the error of at most .5 * 10^-D
+          const int dscale = std::max(0, int(std::ceil(-std::log10(2 * info.tolerance))));
+          if (H5Pset_scaleoffset(prms.getId(), H5Z_SO_FLOAT_DSCALE, dscale) < 0)
+            throw std::runtime_error("libmpdata++: failed to set the scale-offset filter");
+        }
+        if (info.shuffle) prms.setShuffle();
+        if (info.codec != codec_t::none) prms.setDeflate(5); // TODO: move such constant to the header
+#endif
+        return prms;
+      }
+
+      // number of significant bits of the mantissa keeping the relative rounding error below tolerance
+      static int quantize_bits(const info_t &info)
+      {
+        return info.codec == codec_t::quantize
+          ? std::max(1, int(std::ceil(-std::log2(info.tolerance))))
+          : 0;
+      }
+
+      // rounding to the given number of significant bits, leaving the trailing bits of the mantissa zeroed
+      static void quantize(typename solver_t::arr_t &arr, const int bits)
+      {
+        const typename solver_t::real_t scl = std::ldexp(1., bits);
+        for (auto ptr = arr.data(); ptr != arr.data() + arr.numElements(); ++ptr)
+        {
+          int exp;
+          const typename solver_t::real_t mnt = std::frexp(*ptr, &exp);
+          *ptr = std::ldexp(std::round(mnt * scl) / scl, exp);
+        }
+      }
+
+      // part of dset written by this process (in the single-file mode: within the current record)
+      H5::DataSpace file_space(const H5::DataSet &dset, const blitz::TinyVector<hsize_t, parent_t::n_dims> &shp)
+      {
+        return file_space(dset, shp, offst);
+      }
+
+      // as above with the given offset
+      H5::DataSpace file_space(const H5::DataSet &dset, const blitz::TinyVector<hsize_t, parent_t::n_dims> &shp, const blitz::TinyVector<hsize_t, parent_t::n_dims> &off)
+      {
+        H5::DataSpace space = dset.getSpace();
+        if (space.getSimpleExtentNdims() == parent_t::n_dims)
+        {
+          space.selectHyperslab(H5S_SELECT_SET, shp.data(), off.data());
+          return space;
+        }
+
+        hsize_t count[parent_t::n_dims + 1], start[parent_t::n_dims + 1];
+        count[0] = 1;
+        start[0] = n_records - 1;
+        for (int d = 0; d < parent_t::n_dims; ++d)
+        {
+          count[d + 1] = shp[d];
+          start[d + 1] = off[d];
+        }
+        space.selectHyperslab(H5S_SELECT_SET, count, start);
+        return space;
+      }
+
+      bool out_async_supported() const
+      {
+        return true;
+      }
+
+      bool stats_supported() const
+      {
+        return true;
+      }
+
+      // writes the current record (a value or a row of len values) of a series in the statistics file
+      H5::DataSet record_stats_hlpr(const std::string &name, const double *data, const hsize_t len)
+      {
+        info_t info;
+        info.precision = precision_t::float64;
+
+        auto dset = series_dset(*statsp, n_stat_records, name, len > 0 ? H5::DataSpace(1, &len) : H5::DataSpace(), &len, info);
+        H5::DataSpace space = dset.getSpace(), mem_space(1, len > 0 ? &len : &one);
+        const hsize_t count[2] = {1, len}, start[2] = {n_stat_records - 1, 0};
+        space.selectHyperslab(H5S_SELECT_SET, count, start);
+        if (this->mem->distmem.rank() != 0)
+        {
+          space.selectNone();
+          mem_space.selectNone();
+        }
+        dset.write(data, H5::PredType::NATIVE_DOUBLE, mem_space, space, dxpl_id);
+        return dset;
+      }
+
+      void record_stats(const double time, const std::vector<std::vector<double>> &vals)
+      {
+        assert(this->rank == 0);
+        ++n_stat_records;
+
+        record_stats_hlpr("T", &time, 0);
+        for (std::size_t i = 0; i < this->out_stats.size(); ++i)
+        {
+          const auto &s = this->out_stats[i];
+          auto dset = record_stats_hlpr(s.name, vals[i].data(), vals[i].size());
+
+          // bin edges needed to interpret histograms
+          if (s.type == stat_t::histogram && n_stat_records == 1)
+          {
+            dset.createAttribute("lo", H5::PredType::NATIVE_DOUBLE, H5::DataSpace(1, &one)).write(H5::PredType::NATIVE_DOUBLE, &s.lo);
+            dset.createAttribute("hi", H5::PredType::NATIVE_DOUBLE, H5::DataSpace(1, &one)).write(H5::PredType::NATIVE_DOUBLE, &s.hi);
+          }
+        }
+      }
+
+      static std::string pack_key(const std::string &name)
+      {
+        return "hdf5:" + name;
+      }
+
+      // packing implemented for the default codec and precision of variables recorded on the whole domain only
+      bool packable(const info_t &info) const
+      {
+        return info.pack && info.codec == codec_t::deflate && info.precision == precision_t::float32 && !info.shuffle
+          && this->selection(info).full(this->mem->distmem.grid_size);
+      }
+
+      bool pack_requested() const
+      {
+#if defined(LIBMPDATAXX_HDF5_PACK)
+        for (const auto &v : this->outvars)
+          if (packable(v.second)) return true;
+#endif
+        return false;
+      }
+
+      // offset (from the beginning of the subdomain of the process) of the k-th chunk,
+      // the chunks numbered in the C storage order
+      blitz::TinyVector<int, parent_t::n_dims> pack_chunk_offset(int k) const
+      {
+        blitz::TinyVector<int, parent_t::n_dims> off;
+        for (int d = parent_t::n_dims - 1; d >= 0; --d)
+        {
+          off[d] = (k % n_pack_chunk[d]) * pack_chunk[d];
+          k /= n_pack_chunk[d];
+        }
+        return off;
+      }
+
+      // true if the first cell of the k-th chunk is within the subdomain of this thread
+      bool pack_chunk_own(const int k) const
+      {
+        const auto off = pack_chunk_offset(k);
+        for (int d = 0; d < parent_t::n_dims; ++d)
+        {
+          const auto sub = this->mem->subdomain(this->rank, d);
+          const int first = this->mem->grid_size[d].first() + off[d];
+          if (first < sub.first() || first > sub.last()) return false;
+        }
+        return true;
+      }
+
+      // called by all threads, each compressing its chunks (see pack_chunk) of all the packed variables
+      void pack_all()
+      {
+#if defined(LIBMPDATAXX_HDF5_PACK)
+        for (const auto &v : this->outvars)
+        {
+          if (!packable(v.second)) continue;
+          auto &bufs = this->mem->bufs.at(pack_key(v.second.name));
+          for (int k = 0; k < n_pack_chunks; ++k)
+            if (pack_chunk_own(k)) pack_chunk_data(bufs[k], this->out_data(v.first), k);
+        }
+        if (this->rank == 0) packed = true;
+#endif
+      }
+
+#if defined(LIBMPDATAXX_HDF5_PACK)
+      // deflate-compressed k-th chunk of arr in the output type (the chunks at the end of the domain
+      // padded with zeros to the full chunk size, as expected by HDF5)
+      void pack_chunk_data(std::vector<char> &buf, const typename solver_t::arr_t &arr, const int k)
+      {
+        const auto off = pack_chunk_offset(k);
+        blitz::TinyVector<int, parent_t::n_dims> ext, lo, hi, org(0), len;
+        for (int d = 0; d < parent_t::n_dims; ++d)
+        {
+          ext[d] = pack_chunk[d];
+          lo[d] = this->mem->grid_size[d].first() + off[d];
+          hi[d] = std::min(this->mem->grid_size[d].last(), lo[d] + ext[d] - 1);
+        }
+        len = hi - lo;
+
+        std::vector<float> raw(blitz::product(ext), 0);
+        blitz::Array<float, parent_t::n_dims> raw_arr(raw.data(), ext, blitz::neverDeleteData);
+        raw_arr(blitz::RectDomain<parent_t::n_dims>(org, len)) = blitz::cast<float>(
+          arr(blitz::RectDomain<parent_t::n_dims>(lo, hi))
+        );
+
+        const uLong raw_len = raw.size() * sizeof(float);
+        uLongf buf_len = compressBound(raw_len);
+        buf.resize(buf_len);
+        if (compress2(reinterpret_cast<Bytef*>(buf.data()), &buf_len, reinterpret_cast<const Bytef*>(raw.data()), raw_len, 5) != Z_OK)
+          throw std::runtime_error("libmpdata++: zlib compression of output data failed");
+        buf.resize(buf_len);
+      }
+
+      // writing the chunks compressed in pack_all() bypassing the HDF5 filter pipeline
+      void record_packed(const H5::DataSet &dset, const std::string &name)
+      {
+        const auto &bufs = this->mem->bufs.at(pack_key(name));
+        const bool series = dset.getSpace().getSimpleExtentNdims() == parent_t::n_dims + 1;
+        hsize_t offset[parent_t::n_dims + 1] = {};
+        if (series) offset[0] = n_records - 1;
+        for (int k = 0; k < n_pack_chunks; ++k)
+        {
+          const auto off = pack_chunk_offset(k);
+          for (int d = 0; d < parent_t::n_dims; ++d) offset[(series ? 1 : 0) + d] = off[d];
+#if H5_VERSION_GE(1, 10, 3)
+          const herr_t err = H5Dwrite_chunk(dset.getId(), H5P_DEFAULT, 0, offset, bufs[k].size(), bufs[k].data());
+#else
+          const herr_t err = H5DOwrite_chunk(dset.getId(), H5P_DEFAULT, 0, offset, bufs[k].size(), bufs[k].data());
+#endif
+          if (err < 0) throw std::runtime_error("libmpdata++: direct chunk write of " + name + " failed");
+        }
+      }
+#endif
+
       void record_all()
       {
         // in concurrent setup only the first solver does output
         assert(this->rank == 0);
         //count[1] = 1; TODO
 
-        // creating the timestep file
-        hdfp.reset(new H5::H5File(this->outdir + "/" + hdf_name(), H5F_ACC_TRUNC
+        if (out_single_file)
+        {
+          ++n_records;
+
+          // record times
+          auto dset = series_dset(*hdfp, "T", H5::DataSpace());
+          H5::DataSpace space = dset.getSpace(), mem_space(1, &one);
+          const hsize_t start = n_records - 1;
+          space.selectHyperslab(H5S_SELECT_SET, &one, &start);
+          if (this->mem->distmem.rank() != 0)
+          {
+            space.selectNone();
+            mem_space.selectNone();
+          }
+          dset.write(&this->record_time, flttype_solver, mem_space, space, dxpl_id);
+        }
+        else
+        {
+          // creating the timestep file
+          hdfp.reset(new H5::H5File(this->outdir + "/" + hdf_name(), H5F_ACC_TRUNC
 #if defined(USE_MPI)
-            , H5P_DEFAULT, fapl_id
+              , H5P_DEFAULT, fapl_id
 #endif
-        ));
+          ));
+        }
 
         {
           std::map<int, H5::DataSet> vars;
 
           for (const auto &v : this->outvars)
           {
-            // creating the user-requested variables
-            vars[v.first] = (*hdfp).createDataSet(
-              v.second.name,
-              flttype_output,
-              sspace,
-              params
-            );
+            // variables recorded on a part of the domain (a single chunk, not packed)
+            const auto sel = this->selection(v.second);
+            if (!sel.full(this->mem->distmem.grid_size))
+            {
+              blitz::TinyVector<hsize_t, parent_t::n_dims> sel_shape;
+              for (int d = 0; d < parent_t::n_dims; ++d) sel_shape[d] = sel.count[d];
+              const H5::DataSpace sel_space(parent_t::n_dims, sel_shape.data());
+
+              vars[v.first] = out_single_file
+                ? series_dset(*hdfp, v.second.name, sel_space, sel_shape.data(), v.second)
+                : (*hdfp).createDataSet(
+                    v.second.name,
+                    file_type(v.second),
+                    sel_space,
+                    var_params(parent_t::n_dims, sel_shape.data(), v.second)
+                  );
+              record_sel_helper(vars[v.first], this->out_data(v.first), sel, quantize_bits(v.second));
+              continue;
+            }
+
+            // creating the user-requested variables (packed ones chunked as in pack_all())
+            const auto chnk = packable(v.second) ? pack_chunk.data() : chunk.data();
+            vars[v.first] = out_single_file
+              ? series_dset(*hdfp, v.second.name, sspace, chnk, v.second)
+              : (*hdfp).createDataSet(
+                  v.second.name,
+                  file_type(v.second),
+                  sspace,
+                  var_params(parent_t::n_dims, chnk, v.second)
+                );
             // TODO: units attribute
 
-            record_dsc_helper(vars[v.first], this->out_data(v.first));
+#if defined(LIBMPDATAXX_HDF5_PACK)
+            if (packed && packable(v.second))
+            {
+              record_packed(vars[v.first], v.second.name);
+              continue;
+            }
+#endif
+            record_dsc_helper(vars[v.first], this->out_data(v.first), quantize_bits(v.second));
           }
         }
+
+        // with var_dt the same data may be recorded more than once, only the first record is packed
+        packed = false;
+      }
+
+      // true if the memory block of arr can be described by an HDF5 dataspace, i.e. if the data
+      // can be written directly from it (contiguous, in the C storage order, ascending)
+      static bool hdf_layout(const typename solver_t::arr_t &arr)
+      {
+        if (!arr.isStorageContiguous()) return false;
+        for (int d = 0; d < parent_t::n_dims; ++d)
+          if (arr.ordering(d) != parent_t::n_dims - 1 - d || !arr.isRankStoredAscending(d)) return false;
+        return true;
+      }
+
+      // dataspace of the memory block of arr (halos included) with count cells selected starting
+      // from lo (in the indices of arr) with the given stride
+      static H5::DataSpace mem_space(
+        const typename solver_t::arr_t &arr,
+        const blitz::TinyVector<int, parent_t::n_dims> &lo,
+        const blitz::TinyVector<hsize_t, parent_t::n_dims> &count,
+        const blitz::TinyVector<hsize_t, parent_t::n_dims> &stride = blitz::TinyVector<hsize_t, parent_t::n_dims>(1)
+      )
+      {
+        blitz::TinyVector<hsize_t, parent_t::n_dims> dims, start;
+        for (int d = 0; d < parent_t::n_dims; ++d)
+        {
+          dims[d] = arr.extent(d);
+          start[d] = lo[d] - arr.lbound(d);
+        }
+        H5::DataSpace space(parent_t::n_dims, dims.data());
+        space.selectHyperslab(H5S_SELECT_SET, count.data(), start.data(), stride.data());
+        return space;
       }
 
       void record_dsc_srfc_helper(const H5::DataSet &dset, const typename solver_t::arr_t &arr)
       {
-        H5::DataSpace space = dset.getSpace();
-        space.selectHyperslab(H5S_SELECT_SET, srfcshape.data(), offst.data());
+        blitz::TinyVector<hsize_t, parent_t::n_dims> srfcoffst = offst;
+        *(srfcoffst.end()-1) = 0;
+        H5::DataSpace space = file_space(dset, srfcshape, srfcoffst);
+
+        // with the last dimension split between processes, written by the ones at the bottom of the domain
+        if (*(offst.end()-1) != 0)
+        {
+          H5::DataSpace mem_space(parent_t::n_dims, srfcshape.data());
+          space.selectNone();
+          mem_space.selectNone();
+          dset.write(arr.dataFirst(), flttype_solver, mem_space, space, dxpl_id);
+          return;
+        }
+
+        // the lowest level gathered by HDF5 directly from the solver memory
+        if (hdf_layout(arr))
+        {
+          blitz::TinyVector<int, parent_t::n_dims> lo;
+          for (int d = 0; d < parent_t::n_dims; ++d) lo[d] = this->mem->grid_size[d].first();
+          *(lo.end()-1) = 0;
+          dset.write(arr.dataFirst(), flttype_solver, mem_space(arr, lo, srfcshape), space, dxpl_id);
+          return;
+        }
+
         // TODO: some permutation of grid_size instead of the switch
         blitz::Range zro(0,0);
 
@@ -282,10 +816,21 @@ namespace libmpdataxx
         };
       }
 
-      void record_dsc_helper(const H5::DataSet &dset, const typename solver_t::arr_t &arr)
+      // optionally rounding the data to the given number of significant bits (see quantize())
+      void record_dsc_helper(const H5::DataSet &dset, const typename solver_t::arr_t &arr, const int bits = 0)
       {
-        H5::DataSpace space = dset.getSpace();
-        space.selectHyperslab(H5S_SELECT_SET, shape.data(), offst.data());
+        H5::DataSpace space = file_space(dset, shape);
+
+        // the data without halos gathered by HDF5 directly from the solver memory
+        // (copied only if it is to be modified or cannot be described by a dataspace)
+        if (bits == 0 && hdf_layout(arr))
+        {
+          blitz::TinyVector<int, parent_t::n_dims> lo;
+          for (int d = 0; d < parent_t::n_dims; ++d) lo[d] = this->mem->grid_size[d].first();
+          dset.write(arr.dataFirst(), flttype_solver, mem_space(arr, lo, shape), space, dxpl_id);
+          return;
+        }
+
         // TODO: some permutation of grid_size instead of the switch
 
         switch (int(solver_t::n_dims))
@@ -293,18 +838,21 @@ namespace libmpdataxx
           case 1:
           {
             typename solver_t::arr_t contiguous_arr = arr(this->mem->grid_size[0]).copy(); // create a copy that is contiguous
+            if (bits > 0) quantize(contiguous_arr, bits);
             dset.write(contiguous_arr.data(), flttype_solver, H5::DataSpace(parent_t::n_dims, shape.data()), space, dxpl_id);
             break;
           }
           case 2:
           {
             typename solver_t::arr_t contiguous_arr = arr(this->mem->grid_size[0], this->mem->grid_size[1]).copy(); // create a copy that is contiguous
+            if (bits > 0) quantize(contiguous_arr, bits);
             dset.write(contiguous_arr.data(), flttype_solver, H5::DataSpace(parent_t::n_dims, shape.data()), space, dxpl_id);
             break;
           }
           case 3:
           {
             typename solver_t::arr_t contiguous_arr = arr(this->mem->grid_size[0], this->mem->grid_size[1], this->mem->grid_size[2]).copy(); // create a copy that is contiguous
+            if (bits > 0) quantize(contiguous_arr, bits);
             dset.write(contiguous_arr.data(), flttype_solver, H5::DataSpace(parent_t::n_dims, shape.data()), space, dxpl_id);
             break;
           }
@@ -312,56 +860,104 @@ namespace libmpdataxx
         };
       }
 
+      // as above but for the selected part of the domain (see output_common::selection()),
+      // each process writing only the part within its subdomain
+      void record_sel_helper(const H5::DataSet &dset, const typename solver_t::arr_t &arr, const typename parent_t::selection_t &sel, const int bits = 0)
+      {
+        const auto loc = this->local_selection(sel);
+
+        if (loc.empty())
+        {
+          // taking part in the (collective) write with nothing to write
+          H5::DataSpace space = dset.getSpace(), mem_space(1, &one);
+          space.selectNone();
+          mem_space.selectNone();
+          dset.write(nullptr, flttype_solver, mem_space, space, dxpl_id);
+          return;
+        }
+
+        blitz::TinyVector<hsize_t, parent_t::n_dims> count, start, stride;
+        for (int d = 0; d < parent_t::n_dims; ++d)
+        {
+          count[d] = loc.count[d];
+          start[d] = loc.offset[d];
+          stride[d] = loc.stride[d];
+        }
+
+        if (bits == 0 && hdf_layout(arr))
+        {
+          dset.write(arr.dataFirst(), flttype_solver, mem_space(arr, loc.lo, count, stride), file_space(dset, count, start), dxpl_id);
+          return;
+        }
+
+        typename solver_t::arr_t contiguous_arr = arr(loc.domain()).copy(); // create a copy that is contiguous
+        if (bits > 0) quantize(contiguous_arr, bits);
+        dset.write(contiguous_arr.data(), flttype_solver, H5::DataSpace(parent_t::n_dims, count.data()), file_space(dset, count, start), dxpl_id);
+      }
+
       // data is assumed to be contiguous and in the same layout as hdf variable
-      void record_aux_hlpr(const std::string &name, typename solver_t::real_t *data, H5::H5File hdf)
+      void record_aux_hlpr(const std::string &name, typename solver_t::real_t *data, H5::H5File hdf, bool series = false)
       {
         assert(this->rank == 0);
 
-        auto aux = hdf.createDataSet(
-          name,
-          flttype_output,
-          sspace,
-          params
-        );
+        auto aux = series
+          ? series_dset(hdf, name, sspace, chunk.data())
+          : hdf.createDataSet(
+              name,
+              flttype_output,
+              sspace,
+              params
+            );
 
-        auto space = aux.getSpace();
-        space.selectHyperslab(H5S_SELECT_SET, shape.data(), offst.data());
-        aux.write(data, flttype_solver, H5::DataSpace(parent_t::n_dims, shape.data()), space, dxpl_id);
+        aux.write(data, flttype_solver, H5::DataSpace(parent_t::n_dims, shape.data()), file_space(aux, shape), dxpl_id);
       }
 
+      // the auxiliary record methods below can be called from hooks (by rank 0), with out_async
+      // they wait for the writer thread first (the current file, see hdf_name(), is the one
+      // of the last record submitted and the HDF5 library is not used concurrently)
       void record_aux(const std::string &name, typename solver_t::real_t *data)
       {
-        record_aux_hlpr(name, data, *hdfp);
+        this->out_flush();
+        record_aux_hlpr(name, data, *hdfp, out_single_file);
       }
 
       // for discontiguous array with halos
-      void record_aux_dsc_hlpr(const std::string &name, const typename solver_t::arr_t &arr, H5::H5File hdf, bool srfc = false)
+      void record_aux_dsc_hlpr(const std::string &name, const typename solver_t::arr_t &arr, H5::H5File hdf, bool srfc = false, bool series = false)
       {
         assert(this->rank == 0);
 
-        if(srfc)
-          params.setChunk(parent_t::n_dims, srfcchunk.data());
+        H5::DataSet aux;
+        if (series)
+        {
+          aux = series_dset(hdf, name, srfc ? srfcspace : sspace, srfc ? srfcchunk.data() : chunk.data());
+        }
+        else
+        {
+          if(srfc)
+            params.setChunk(parent_t::n_dims, srfcchunk.data());
 
-        auto aux = hdf.createDataSet(
-          name,
-          flttype_output,
-          srfc ? srfcspace : sspace,
-          params
-        );
+          aux = hdf.createDataSet(
+            name,
+            flttype_output,
+            srfc ? srfcspace : sspace,
+            params
+          );
 
-        if(srfc)
-        {
           // revert to default chunk
-          params.setChunk(parent_t::n_dims, chunk.data());
-          record_dsc_srfc_helper(aux, arr);
+          if(srfc)
+            params.setChunk(parent_t::n_dims, chunk.data());
         }
+
+        if(srfc)
+          record_dsc_srfc_helper(aux, arr);
         else
           record_dsc_helper(aux, arr);
       }
 
       void record_aux_dsc(const std::string &name, const typename solver_t::arr_t &arr, bool srfc = false)
       {
-        record_aux_dsc_hlpr(name, arr, *hdfp, srfc);
+        this->out_flush();
+        record_aux_dsc_hlpr(name, arr, *hdfp, srfc, out_single_file);
       }
 
 
@@ -383,28 +979,30 @@ namespace libmpdataxx
         group.createAttribute(name, flttype_output, H5::DataSpace(1, &one)).write(flttype_output, &data_f);
       }
 
-      // has to be called after const file was created (i.e. after start())
+      // reopens the const file (by all processes, with MPI-IO), has to be called after start()
+      H5::H5File const_hdf()
+      {
+        this->out_flush();
+        return H5::H5File(const_file, H5F_ACC_RDWR
+#if defined(USE_MPI)
+          , H5P_DEFAULT, fapl_id
+#endif
+        );
+      }
+
       void record_aux_const(const std::string &name, typename solver_t::real_t *data)
       {
-        H5::H5File hdfcp(const_file, H5F_ACC_RDWR); // reopen the const file
-        record_aux_hlpr(name, data, hdfcp);
+        record_aux_hlpr(name, data, const_hdf());
       }
 
-      // has to be called after const file was created (i.e. after start())
       void record_aux_dsc_const(const std::string &name,  const typename solver_t::arr_t &arr)
       {
-        H5::H5File hdfcp(const_file, H5F_ACC_RDWR); // reopen the const file
-        record_aux_dsc_hlpr(name, arr, hdfcp);
+        record_aux_dsc_hlpr(name, arr, const_hdf());
       }
 
       void record_aux_const(const std::string &name, const std::string &group_name, typename solver_t::real_t data)
       {
-        H5::H5File hdfcp(const_file, H5F_ACC_RDWR
-#if defined(USE_MPI)
-          , H5P_DEFAULT, fapl_id
-#endif
-        ); // reopen the const file
-        record_scalar_hlpr(name, group_name, data, hdfcp);
+        record_scalar_hlpr(name, group_name, data, const_hdf());
       }
 
       void record_aux_const(const std::string &name, typename solver_t::real_t data)
@@ -414,7 +1012,32 @@ namespace libmpdataxx
 
       void record_aux_scalar(const std::string &name, const std::string &group_name, typename solver_t::real_t data)
       {
-        record_scalar_hlpr(name, group_name, data, *hdfp);
+        this->out_flush();
+
+        if (!out_single_file)
+        {
+          record_scalar_hlpr(name, group_name, data, *hdfp);
+          return;
+        }
+
+        // in the single-file mode scalars are stored as one-dimensional series instead of attributes
+        assert(this->rank == 0);
+        H5::Group group;
+        if (group_name == "/" || H5Lexists(hdfp->getId(), group_name.c_str(), H5P_DEFAULT) > 0)
+          group = hdfp->openGroup(group_name);
+        else
+          group = hdfp->createGroup(group_name);
+
+        auto dset = series_dset(group, name, H5::DataSpace());
+        H5::DataSpace space = dset.getSpace(), mem_space(1, &one);
+        const hsize_t start = n_records - 1;
+        space.selectHyperslab(H5S_SELECT_SET, &one, &start);
+        if (this->mem->distmem.rank() != 0)
+        {
+          space.selectNone();
+          mem_space.selectNone();
+        }
+        dset.write(&data, flttype_solver, mem_space, space, dxpl_id);
       }
 
       void record_aux_scalar(const std::string &name, typename solver_t::real_t data)
@@ -422,31 +1045,35 @@ namespace libmpdataxx
         record_aux_scalar(name, "/", data);
       }
 
-      // see above, also assumes that z is the last dimension
+      // has to be called after start(), assumes that z is the last dimension
       void record_prof_const(const std::string &name, typename solver_t::real_t *data)
       {
         assert(this->rank == 0);
 
-        H5::H5File hdfcp(const_file, H5F_ACC_RDWR
-#if defined(USE_MPI)
-          , H5P_DEFAULT, fapl_id
-#endif
-        ); // reopen the const file
+        H5::H5File hdfcp = const_hdf();
 
+        const hsize_t len = this->mem->distmem.grid_size[parent_t::n_dims - 1];
         auto aux = hdfcp.createDataSet(
           name,
           flttype_output,
-          H5::DataSpace(1, &shape[parent_t::n_dims - 1])
+          H5::DataSpace(1, &len)
         );
 
-#if defined(USE_MPI)
-        if (this->mem->distmem.rank() == 0)
-#endif
+        // written collectively, by the processes at the beginning of the domain in the other dimensions
+        // (each its part of the profile if the last dimension is split between processes)
+        auto space = aux.getSpace();
+        H5::DataSpace mem_space(1, &len);
+        mem_space.selectHyperslab(H5S_SELECT_SET, &shape[parent_t::n_dims - 1], &offst[parent_t::n_dims - 1]);
+        space.selectHyperslab(H5S_SELECT_SET, &shape[parent_t::n_dims - 1], &offst[parent_t::n_dims - 1]);
+        for (int d = 0; d < parent_t::n_dims - 1; ++d)
         {
-          auto space = aux.getSpace();
-          space.selectHyperslab(H5S_SELECT_SET, &shape[parent_t::n_dims - 1], &offst[parent_t::n_dims - 1]);
-          aux.write(data, flttype_solver, H5::DataSpace(1, &shape[parent_t::n_dims - 1]), space);
+          if (offst[d] != 0)
+          {
+            space.selectNone();
+            mem_space.selectNone();
+          }
         }
+        aux.write(data, flttype_solver, mem_space, space, dxpl_id);
       }
 
       // parameters saved for pure advection solvers
@@ -615,11 +1242,27 @@ namespace libmpdataxx
 
       public:
 
+      void state_io(concurr::detail::state_io_t &io)
+      {
+        parent_t::state_io(io);
+        io(n_records);
+        io(n_stat_records);
+      }
+
+      struct rt_params_t : parent_t::rt_params_t
+      {
+        bool out_single_file = false; // all records appended to extensible datasets in a single file
+        hsize_t out_alignment = 0;    // with MPI: stripe size of the file system (in bytes) the datasets are aligned with, 0 for none
+      };
+
       // ctor
       hdf5(
         typename parent_t::ctor_args_t args,
-        const typename parent_t::rt_params_t &p
-      ) : parent_t(args, p)
+        const rt_params_t &p
+      ) :
+        parent_t(args, p),
+        out_single_file(p.out_single_file),
+        out_alignment(p.out_alignment)
       {
 #if defined(USE_MPI)
         fapl_id = H5Pcreate(H5P_FILE_ACCESS);
@@ -630,11 +1273,21 @@ namespace libmpdataxx
         // overrding the default from output_common
         if (this->outvars.size() == 1 && parent_t::n_eqns == 1)
           this->outvars[0].name = "psi";
+
+        for (const auto &v : this->outvars)
+        {
+          const bool lossy = v.second.codec == codec_t::quantize || v.second.codec == codec_t::fixed_accuracy;
+          if (lossy && !(v.second.tolerance > 0))
+            throw std::runtime_error("libmpdata++: positive tolerance required for the lossy codec of " + v.second.name);
+          if (v.second.codec == codec_t::fixed_accuracy && v.second.precision == precision_t::float16)
+            throw std::runtime_error("libmpdata++: fixed_accuracy codec not available with float16 precision (" + v.second.name + ")");
+        }
       }
 
       // dtor
       virtual ~hdf5()
       {
+        this->out_flush();
         H5Pclose(dxpl_id);
 #if defined(USE_MPI)
         H5Pclose(fapl_id);
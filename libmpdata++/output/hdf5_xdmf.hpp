@@ -21,6 +21,9 @@
 #include <string>
 #include <sstream>
 #include <iomanip>
+#include <algorithm>
+#include <cctype>
+
 namespace libmpdataxx
 {
   namespace output
@@ -51,13 +54,52 @@ namespace libmpdataxx
           std::vector<std::string> attr_names;
           for (const auto &v : this->outvars)
           {
+            // variables recorded on a part of the domain on separate grids
+            const auto sel = this->selection(v.second);
+            if (!sel.full(this->mem->distmem.grid_size))
+            {
+              std::map<int, std::string> coord_names;
+              for (const auto &dn : this->dim_names)
+                coord_names[dn.first] = parent_t::sel_coord_name(dn.second, v.second.name);
+              xdmfw.add_subgrid(v.second.name, this->const_name, coord_names, sel.count);
+              continue;
+            }
             attr_names.push_back(v.second.name);
           }
 
           if (this->mem->G.get() != nullptr) xdmfw.add_const_attribute("G", this->const_name, this->mem->distmem.grid_size.data());
 
           xdmfw.setup(this->const_name, this->dim_names, attr_names, this->mem->distmem.grid_size.data());
+
+          if (this->out_single_file) xdmfw.open_series(this->outdir + "/series.xmf", this->restarted);
+          else if (this->restarted) restore_timesteps();
+        }
+      }
+
+      // after a restart from a checkpoint the temporal xmf lists also the records made before it,
+      // i.e. the per-record xmf files in outdir up to the last record before the checkpoint
+      void restore_timesteps()
+      {
+        timesteps.clear();
+        for (boost::filesystem::directory_iterator it(this->outdir), end; it != end; ++it)
+        {
+          const std::string name = it->path().filename().string();
+          const std::string prefix = "timestep", suffix = ".xmf"; // see base_name()
+          if (
+            name.size() != prefix.size() + 10 + suffix.size() ||
+            name.compare(0, prefix.size(), prefix) != 0 ||
+            name.compare(name.size() - suffix.size(), suffix.size(), suffix) != 0
+          ) continue;
+
+          const std::string digits = name.substr(prefix.size(), 10);
+          if (!std::all_of(digits.begin(), digits.end(), ::isdigit)) continue;
+
+          // records written after the checkpoint by the interrupted run are going to be overwritten
+          if (std::stoll(digits) > this->record_timestep) continue;
+
+          timesteps.push_back(name);
         }
+        std::sort(timesteps.begin(), timesteps.end()); // zero-padded, hence in temporal order
       }
 
       void write_xmfs()
@@ -66,6 +108,13 @@ namespace libmpdataxx
         if (this->mem->distmem.rank() == 0)
 #endif
         {
+          if (this->out_single_file)
+          {
+            // called before the record is started in the hdf5 file, hence n_records is its index
+            xdmfw.append_series(this->hdf_name(), this->n_records, this->record_time);
+            return;
+          }
+
           // write xdmf markup
           std::string xmf_name = this->base_name() + ".xmf";
           xdmfw.write(this->outdir + "/" + xmf_name, this->hdf_name(), this->record_time);
@@ -85,6 +134,7 @@ namespace libmpdataxx
 
       void record_aux(const std::string &name, typename solver_t::real_t *data)
       {
+        this->out_flush(); // xdmfw and hdf_name() used by the writer thread
 #if defined(USE_MPI)
         if (this->mem->distmem.rank() == 0)
 #endif
@@ -94,6 +144,7 @@ namespace libmpdataxx
 
       void record_aux_dsc(const std::string &name, const typename solver_t::arr_t &arr, bool srfc = false)
       {
+        this->out_flush(); // ditto
         auto shape = this->mem->distmem.grid_size;
         if(srfc) shape.at(parent_t::n_dims-1) = 1;
 #if defined(USE_MPI)
@@ -111,6 +162,12 @@ namespace libmpdataxx
         const typename parent_t::rt_params_t &p
       ) : parent_t(args, p)
       {}
+
+      // dtor
+      virtual ~hdf5_xdmf()
+      {
+        this->out_flush(); // pending records use xdmfw
+      }
     };
   } // namespace output
 } // namespace libmpdataxx
@@ -0,0 +1,116 @@
+/**
+ * @file
+ * @copyright University of Warsaw
+ * @section LICENSE
+ * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
+ * @brief output keeping the last records of the output variables in memory
+ *   (e.g. for exchanging data with a coupled model without going through files),
+ *   accessible with history(), history_time() and history_size() of concurr::any
+ */
+
+#pragma once
+
+#include <libmpdata++/output/detail/output_common.hpp>
+
+#include <string>
+#include <stdexcept>
+
+namespace libmpdataxx
+{
+  namespace output
+  {
+    template <class solver_t>
+    class memory : public detail::output_common<solver_t>
+    {
+      using parent_t = detail::output_common<solver_t>;
+
+      protected:
+
+      using output_t = memory<solver_t>;
+
+      const int out_history;
+      bool copied = false; // true if pack_all() was called for the data to be recorded
+
+      // the ring buffers allocated in the first call (covering the part of the output grid
+      // within the subdomain of the process, see output_common::selection())
+      void start(const typename parent_t::advance_arg_t nt)
+      {
+        for (const auto &v : this->outvars)
+        {
+          auto &h = this->mem->history[v.second.name];
+          if (!h.slots.empty()) continue;
+
+          const auto loc = this->local_selection(this->selection(v.second));
+          for (int s = 0; s < out_history; ++s)
+          {
+            h.slots.push_back(typename parent_t::arr_t(loc.count));
+            h.slots.back().reindexSelf(loc.offset);
+          }
+          h.times.resize(out_history);
+        }
+      }
+
+      // the records copied by all threads, each copying its subdomain
+      bool pack_requested() const
+      {
+        return true;
+      }
+
+      void pack_all()
+      {
+        for (const auto &v : this->outvars)
+        {
+          auto &h = this->mem->history.at(v.second.name);
+          const auto loc = this->local_selection(this->selection(v.second), this->ijk.lbound(), this->ijk.ubound());
+          if (!loc.empty()) copy(h.slots[h.next], this->out_data(v.first), loc);
+        }
+        if (this->rank == 0) copied = true;
+      }
+
+      static void copy(typename parent_t::arr_t &slot, const typename parent_t::arr_t &arr, const typename parent_t::local_selection_t &loc)
+      {
+        const blitz::TinyVector<int, parent_t::n_dims> last = loc.offset + loc.count - 1;
+        slot(blitz::RectDomain<parent_t::n_dims>(loc.offset, last)) = arr(loc.domain());
+      }
+
+      void record_all()
+      {
+        for (const auto &v : this->outvars)
+        {
+          auto &h = this->mem->history.at(v.second.name);
+
+          // with var_dt the same data may be recorded more than once, only the first record is copied in parallel
+          if (!copied)
+          {
+            const auto loc = this->local_selection(this->selection(v.second));
+            if (!loc.empty()) copy(h.slots[h.next], this->out_data(v.first), loc);
+          }
+
+          h.times[h.next] = this->record_time;
+          h.next = (h.next + 1) % out_history;
+          h.n_recs = std::min(h.n_recs + 1, out_history);
+        }
+        copied = false;
+      }
+
+      public:
+
+      struct rt_params_t : parent_t::rt_params_t
+      {
+        int out_history = 1; // number of records of each variable kept
+      };
+
+      // ctor
+      memory(
+        typename parent_t::ctor_args_t args,
+        const rt_params_t &p
+      ) :
+        parent_t(args, p),
+        out_history(p.out_history)
+      {
+        if (out_history < 1)
+          throw std::runtime_error("out_history must be positive");
+      }
+    };
+  } // namespace output
+} // namespace libmpdataxx
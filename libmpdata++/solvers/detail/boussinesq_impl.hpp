@@ -41,7 +41,10 @@ namespace libmpdataxx
         void calc_dtht_e(typename std::enable_if<nd == 3>::type* = 0)
         {
           this->xchng_sclr(this->tht_e, this->ijk);
-          this->dtht_e(this->ijk) = formulae::nabla::grad<2>(this->tht_e, this->k, this->i, this->j, this->dk);
+          this->tiled(this->i, this->j, this->k, [&](const rng_t &i, const rng_t &j, const rng_t &k)
+          {
+            this->dtht_e(i, j, k) = formulae::nabla::grad<2>(this->tht_e, k, i, j, this->dk);
+          });
         }
 
         void calc_full_tht(typename parent_t::arr_t &full_tht) final
@@ -74,6 +77,7 @@ namespace libmpdataxx
             (1 + real_t(0.25) * this->dt * this->dt * this->g / this->Tht_ref * this->dtht_e(this->ijk)
                  / (1 + real_t(0.5) * this->dt * this->tht_abs(this->ijk)));
           }
+          for (int d = 0; d < ct_params_t::n_dims; ++d) this->invalidate_halo(this->vip_ixs[d]); // v might be vips()
         }
 
         void update_rhs(
@@ -116,6 +120,7 @@ namespace libmpdataxx
           parent_t::vip_rhs_impl_fnlz();
 
           const auto &w = this->vips()[ct_params_t::n_dims - 1];
+          this->invalidate_halo(ix::tht);
           this->state(ix::tht)(this->ijk) = ( this->state(ix::tht)(this->ijk)
                                             - real_t(0.5) * this->dt * w(this->ijk) * this->dtht_e(this->ijk))
                                             / (1 + real_t(0.5) * this->dt * this->tht_abs(this->ijk));
@@ -68,9 +68,11 @@ namespace libmpdataxx
           this->calc_full_tht(full_tht);
 
           this->xchng_pres(full_tht, this->ijk);
-          formulae::nabla::calc_grad_cmpct<parent_t::n_dims>(grad_tht, this->full_tht, this->ijk, this->ijkm, this->dijk);
-
-          tdef_sq(this->ijk) = formulae::stress::calc_tdef_sq_cmpct<ct_params_t::n_dims>(this->tau, this->ijk);
+          this->tiled(this->ijk, [&](const idx_t<ct_params_t::n_dims> &t)
+          {
+            formulae::nabla::calc_grad_cmpct<parent_t::n_dims>(grad_tht, this->full_tht, t, this->tile_faces(t, this->ijk, this->ijkm), this->dijk);
+            tdef_sq(t) = formulae::stress::calc_tdef_sq_cmpct<ct_params_t::n_dims>(this->tau, t);
+          });
 
           calc_rcdsn_num();
 
@@ -91,15 +93,18 @@ namespace libmpdataxx
 
           // havo to use modified ijkm due to shared-memory parallelisation, otherwise overlapping ranges
           // would lead to double multiplications
-          formulae::stress::multiply_tnsr_cmpct<ct_params_t::n_dims, ct_params_t::opts>(this->tau,
-                                                                                        real_t(1.0),
-                                                                                        this->k_m,
-                                                                                        *this->mem->G,
-                                                                                        this->ijkm_sep);
+          this->tiled(this->ijkm_sep, [&](const idx_t<ct_params_t::n_dims> &t)
+          {
+            formulae::stress::multiply_tnsr_cmpct<ct_params_t::n_dims, ct_params_t::opts>(this->tau,
+                                                                                          real_t(1.0),
+                                                                                          this->k_m,
+                                                                                          *this->mem->G,
+                                                                                          t);
+          });
 
           this->xchng_sgs_tnsr_offdiag(this->tau, this->tau_srfc, this->ijk, this->ijkm);
 
-          // ijk_vec is used, because MPI requires that thread rank 0 calculates next vector to the left of the process' domain
+          // ijk_vec is used, because MPI requires that the leftmost threads calculate next vector to the left of the process' domain
           formulae::stress::multiply_vctr_cmpct<ct_params_t::n_dims, ct_params_t::opts>(grad_tht,
                                                                                         real_t(1.0) / prandtl_num,
                                                                                         this->k_m,
@@ -108,10 +113,13 @@ namespace libmpdataxx
 
           this->xchng_sgs_vctr(grad_tht, hflux_srfc, this->ijk);
           // hack, convinient place to update the heat flux forcing
-          this->hflux_frc(this->ijk) = formulae::stress::flux_div_cmpct<parent_t::n_dims, ct_params_t::opts>(grad_tht,
-                                                                                                             *this->mem->G,
-                                                                                                             this->ijk,
-                                                                                                             this->dijk);
+          this->tiled(this->ijk, [&](const idx_t<ct_params_t::n_dims> &t)
+          {
+            this->hflux_frc(t) = formulae::stress::flux_div_cmpct<parent_t::n_dims, ct_params_t::opts>(grad_tht,
+                                                                                                        *this->mem->G,
+                                                                                                        t,
+                                                                                                        this->dijk);
+          });
         }
 
         public:
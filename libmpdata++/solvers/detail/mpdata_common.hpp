@@ -105,8 +105,8 @@ namespace libmpdataxx
         ) {
           parent_t::alloc(mem, n_iters);
           for (int n = 0; n < n_tmp(n_iters); ++n)
-            parent_t::alloc_tmp_vctr(mem, __FILE__);
-          parent_t::alloc_tmp_vctr(mem, __FILE__); // fluxes
+            parent_t::alloc_tmp_vctr(mem, __FILE__, tmp_phase::advop);
+          parent_t::alloc_tmp_vctr(mem, __FILE__, tmp_phase::advop); // fluxes
         }
       };
 
@@ -33,25 +33,28 @@ namespace libmpdataxx
           const auto i1 = this->i^1, j1 = this->j^1, k1 = this->k^1; // not optimal - with multiple threads some indices are repeated among threads
           const auto psi = this->mem->psi[e][this->n[e]];
 
-          this->psi_min(i1,j1,k1) = min(min(min(min(min(min(
-                        psi(i1,  j1,  k1),
-                        psi(i1+1,j1,  k1)),
-                        psi(i1-1,j1,  k1)),
-                        psi(i1,  j1+1,k1)),
-                        psi(i1,  j1-1,k1)),
-                        psi(i1,  j1,  k1+1)),
-                        psi(i1,  j1,  k1-1)
-          );
-
-          this->psi_max(i1,j1,k1) = max(max(max(max(max(max(
-                        psi(i1,  j1,  k1),
-                        psi(i1+1,j1,  k1)),
-                        psi(i1-1,j1,  k1)),
-                        psi(i1,  j1+1,k1)),
-                        psi(i1,  j1-1,k1)),
-                        psi(i1,  j1,  k1+1)),
-                        psi(i1,  j1,  k1-1)
-          );
+          this->tiled(i1, j1, k1, [&](const rng_t &i1, const rng_t &j1, const rng_t &k1)
+          {
+            this->psi_min(i1,j1,k1) = min(min(min(min(min(min(
+                          psi(i1,  j1,  k1),
+                          psi(i1+1,j1,  k1)),
+                          psi(i1-1,j1,  k1)),
+                          psi(i1,  j1+1,k1)),
+                          psi(i1,  j1-1,k1)),
+                          psi(i1,  j1,  k1+1)),
+                          psi(i1,  j1,  k1-1)
+            );
+
+            this->psi_max(i1,j1,k1) = max(max(max(max(max(max(
+                          psi(i1,  j1,  k1),
+                          psi(i1+1,j1,  k1)),
+                          psi(i1-1,j1,  k1)),
+                          psi(i1,  j1+1,k1)),
+                          psi(i1,  j1-1,k1)),
+                          psi(i1,  j1,  k1+1)),
+                          psi(i1,  j1,  k1-1)
+            );
+          });
         }
 
         void fct_adjust_antidiff(int e, int iter)
@@ -59,13 +62,10 @@ namespace libmpdataxx
           const auto psi = this->mem->psi[e][this->n[e]];
           auto &GC_corr = parent_t::GC_corr(iter);
           const auto &G = *this->mem->G;
-          const auto &im(this->im), &jm(this->jm), &km(this->km); // calculating once for (i/j/k)-1/2 and (i/j/k)+1/2
-
           // not optimal - with multiple threads some indices are repeated among threads
           const auto
             i = this->i, j = this->j, k = this->k,
-            i1 = i^1, j1 = j^1, k1 = k^1,
-            im1 = this->im^1, jm1 = this->jm^1, km1 = this->km^1;
+            i1 = i^1, j1 = j^1, k1 = k^1;
 
           // fill halos -> mpdata works with halo=1, we need halo=2
           this->xchng_vctr_alng(GC_corr, true);
@@ -78,9 +78,13 @@ namespace libmpdataxx
           }
           else
           {
-            this->flux[0](im1+h, j1,    k1   ) = formulae::donorcell::make_flux<ct_params_t::opts, 0>(psi, GC_corr[0], im1, j1, k1);
-            this->flux[1](i1,    jm1+h, k1   ) = formulae::donorcell::make_flux<ct_params_t::opts, 1>(psi, GC_corr[1], jm1, k1, i1);
-            this->flux[2](i1,    j1,    km1+h) = formulae::donorcell::make_flux<ct_params_t::opts, 2>(psi, GC_corr[2], km1, i1, j1);
+            this->tiled(i1, j1, k1, [&](const rng_t &ti, const rng_t &tj, const rng_t &tk)
+            {
+              const rng_t tim = this->tile_faces(ti, i1), tjm = this->tile_faces(tj, j1), tkm = this->tile_faces(tk, k1);
+              this->flux[0](tim+h, tj,    tk   ) = formulae::donorcell::make_flux<ct_params_t::opts, 0>(psi, GC_corr[0], tim, tj, tk);
+              this->flux[1](ti,    tjm+h, tk   ) = formulae::donorcell::make_flux<ct_params_t::opts, 1>(psi, GC_corr[1], tjm, tk, ti);
+              this->flux[2](ti,    tj,    tkm+h) = formulae::donorcell::make_flux<ct_params_t::opts, 2>(psi, GC_corr[2], tkm, ti, tj);
+            });
             this->flux_ptr = &this->flux;
           }
 
@@ -88,8 +92,11 @@ namespace libmpdataxx
           const auto &flx = (*(this->flux_ptr));
 
           // calculating betas
-          formulae::mpdata::beta_up<ct_params_t::opts>(this->beta_up, psi, this->psi_max, flx, G, i1, j1, k1);
-          formulae::mpdata::beta_dn<ct_params_t::opts>(this->beta_dn, psi, this->psi_min, flx, G, i1, j1, k1);
+          this->tiled(i1, j1, k1, [&](const rng_t &i1, const rng_t &j1, const rng_t &k1)
+          {
+            formulae::mpdata::beta_up<ct_params_t::opts>(this->beta_up, psi, this->psi_max, flx, G, i1, j1, k1);
+            formulae::mpdata::beta_dn<ct_params_t::opts>(this->beta_dn, psi, this->psi_min, flx, G, i1, j1, k1);
+          });
 
 
           // should detect the need for ext=1 in hallo-filling above
@@ -104,9 +111,13 @@ namespace libmpdataxx
           this->beta_barrier(iter);
 
           // calculating the monotonic corrective velocity
-          formulae::mpdata::GC_mono<ct_params_t::opts, 0>(this->GC_mono, psi, this->beta_up, this->beta_dn, GC_corr, G, im, this->j, this->k);
-          formulae::mpdata::GC_mono<ct_params_t::opts, 1>(this->GC_mono, psi, this->beta_up, this->beta_dn, GC_corr, G, jm, this->k, this->i);
-          formulae::mpdata::GC_mono<ct_params_t::opts, 2>(this->GC_mono, psi, this->beta_up, this->beta_dn, GC_corr, G, km, this->i, this->j);
+          this->tiled(i, j, k, [&](const rng_t &ti, const rng_t &tj, const rng_t &tk)
+          {
+            const rng_t tim = this->tile_faces(ti, i), tjm = this->tile_faces(tj, j), tkm = this->tile_faces(tk, k);
+            formulae::mpdata::GC_mono<ct_params_t::opts, 0>(this->GC_mono, psi, this->beta_up, this->beta_dn, GC_corr, G, tim, tj, tk);
+            formulae::mpdata::GC_mono<ct_params_t::opts, 1>(this->GC_mono, psi, this->beta_up, this->beta_dn, GC_corr, G, tjm, tk, ti);
+            formulae::mpdata::GC_mono<ct_params_t::opts, 2>(this->GC_mono, psi, this->beta_up, this->beta_dn, GC_corr, G, tkm, ti, tj);
+          });
         }
 
       };
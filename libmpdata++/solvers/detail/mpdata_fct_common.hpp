@@ -61,9 +61,9 @@ namespace libmpdataxx
           const int &n_iters
         ) {
           parent_t::alloc(mem, n_iters);
-          parent_t::alloc_tmp_sclr(mem, __FILE__, 2); // psi_min and psi_max
-          parent_t::alloc_tmp_vctr(mem, __FILE__);    // GC_mono
-          parent_t::alloc_tmp_sclr(mem, __FILE__, 2); // beta_up, beta_dn
+          parent_t::alloc_tmp_sclr(mem, __FILE__, 2, "", false, tmp_phase::advop); // psi_min and psi_max
+          parent_t::alloc_tmp_vctr(mem, __FILE__, tmp_phase::advop);                // GC_mono
+          parent_t::alloc_tmp_sclr(mem, __FILE__, 2, "", false, tmp_phase::advop); // beta_up, beta_dn
         }
       };
 
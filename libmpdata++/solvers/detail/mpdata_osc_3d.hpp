@@ -32,6 +32,9 @@ namespace libmpdataxx
       {
         using parent_t = detail::mpdata_common<ct_params_t, minhalo>;
 
+        static_assert(!ct_params_t::overlap_xchng || (!ct_params_t::fused_advop && !opts::isset(ct_params_t::opts, opts::fct)),
+          "overlap_xchng is not supported with fused_advop nor with fct");
+
         protected:
 
         // member fields
@@ -69,9 +72,83 @@ namespace libmpdataxx
           }
         }
 
+        // calculating the antidiffusive C in all three dimensions
+        void calc_antidiff(int e, int iter, const rng_t &im, const rng_t &jm, const rng_t &km,
+                                            const rng_t &i,  const rng_t &j,  const rng_t &k)
+        {
+          formulae::mpdata::antidiff<ct_params_t::opts, 0,
+                                     static_cast<sptl_intrp_t>(ct_params_t::sptl_intrp),
+                                     static_cast<tmprl_extrp_t>(ct_params_t::tmprl_extrp)>(
+            this->GC_corr(iter)[0],
+            this->mem->psi[e][this->n[e]],
+            this->mem->psi[e][this->n[e]-1],
+            this->GC_unco(iter),
+            this->mem->ndt_GC,
+            this->mem->ndtt_GC,
+            *this->mem->G,
+            im,
+            j,
+            k
+          );
+
+          formulae::mpdata::antidiff<ct_params_t::opts, 1,
+                                     static_cast<sptl_intrp_t>(ct_params_t::sptl_intrp),
+                                     static_cast<tmprl_extrp_t>(ct_params_t::tmprl_extrp)>(
+            this->GC_corr(iter)[1],
+            this->mem->psi[e][this->n[e]],
+            this->mem->psi[e][this->n[e]-1],
+            this->GC_unco(iter),
+            this->mem->ndt_GC,
+            this->mem->ndtt_GC,
+            *this->mem->G,
+            jm,
+            k,
+            i
+          );
+
+          formulae::mpdata::antidiff<ct_params_t::opts, 2,
+                                     static_cast<sptl_intrp_t>(ct_params_t::sptl_intrp),
+                                     static_cast<tmprl_extrp_t>(ct_params_t::tmprl_extrp)>(
+            this->GC_corr(iter)[2],
+            this->mem->psi[e][this->n[e]],
+            this->mem->psi[e][this->n[e]-1],
+            this->GC_unco(iter),
+            this->mem->ndt_GC,
+            this->mem->ndtt_GC,
+            *this->mem->G,
+            km,
+            i,
+            j
+          );
+        }
+
+        // halo-filling and fct limiting of the antidiffusive C
+        void antidiff_post(int e, int iter)
+        {
+          if (opts::isset(ct_params_t::opts, opts::div_3rd_dt))
+            this->mem->barrier();
+
+          // filling Y and Z halos for GC_x, X and Z halos for GC_y, X and Y halos for GC_z
+          // needed for calculation of antidiffusive velocities in the third and subsequent
+          // iterations, also needed for fct but it is done there independently hence
+          // the following check
+          if (!opts::isset(ct_params_t::opts, opts::fct) && iter != (this->n_iters - 1))
+          {
+            this->xchng_vctr_nrml(this->GC_corr(iter), this->ijk);
+            // if dfl option is set we need to fill these as well
+            if (opts::isset(ct_params_t::opts, opts::dfl)) this->xchng_vctr_alng(this->GC_corr(iter));
+          }
+
+          this->fct_adjust_antidiff(e, iter);
+
+          // TODO: shouldn't the above halo-filling be repeated here?
+        }
+
         // method invoked by the solver
         void advop(int e)
         {
+          if (ct_params_t::fused_advop) return advop_fused(e);
+
           this->fct_init(e);
 
           for (int iter = 0; iter < this->n_iters; ++iter)
@@ -82,68 +159,14 @@ namespace libmpdataxx
               this->xchng(e);
 
               // calculating the antidiffusive C
-              formulae::mpdata::antidiff<ct_params_t::opts, 0,
-                                         static_cast<sptl_intrp_t>(ct_params_t::sptl_intrp),
-                                         static_cast<tmprl_extrp_t>(ct_params_t::tmprl_extrp)>(
-                this->GC_corr(iter)[0],
-                this->mem->psi[e][this->n[e]],
-                this->mem->psi[e][this->n[e]-1],
-                this->GC_unco(iter),
-                this->mem->ndt_GC,
-                this->mem->ndtt_GC,
-                *this->mem->G,
-                this->im,
-                this->j,
-                this->k
-              );
-
-              formulae::mpdata::antidiff<ct_params_t::opts, 1,
-                                         static_cast<sptl_intrp_t>(ct_params_t::sptl_intrp),
-                                         static_cast<tmprl_extrp_t>(ct_params_t::tmprl_extrp)>(
-                this->GC_corr(iter)[1],
-                this->mem->psi[e][this->n[e]],
-                this->mem->psi[e][this->n[e]-1],
-                this->GC_unco(iter),
-                this->mem->ndt_GC,
-                this->mem->ndtt_GC,
-                *this->mem->G,
-                this->jm,
-                this->k,
-                this->i
-              );
-
-              formulae::mpdata::antidiff<ct_params_t::opts, 2,
-                                         static_cast<sptl_intrp_t>(ct_params_t::sptl_intrp),
-                                         static_cast<tmprl_extrp_t>(ct_params_t::tmprl_extrp)>(
-                this->GC_corr(iter)[2],
-                this->mem->psi[e][this->n[e]],
-                this->mem->psi[e][this->n[e]-1],
-                this->GC_unco(iter),
-                this->mem->ndt_GC,
-                this->mem->ndtt_GC,
-                *this->mem->G,
-                this->km,
-                this->i,
-                this->j
-              );
-
-              if (opts::isset(ct_params_t::opts, opts::div_3rd_dt))
-                this->mem->barrier();
-
-              // filling Y and Z halos for GC_x, X and Z halos for GC_y, X and Y halos for GC_z
-              // needed for calculation of antidiffusive velocities in the third and subsequent
-              // iterations, also needed for fct but it is done there independently hence
-              // the following check
-              if (!opts::isset(ct_params_t::opts, opts::fct) && iter != (this->n_iters - 1))
+              this->tiled(this->i, this->j, this->k, [&](const rng_t &i, const rng_t &j, const rng_t &k)
               {
-                this->xchng_vctr_nrml(this->GC_corr(iter), this->ijk);
-                // if dfl option is set we need to fill these as well
-                if (opts::isset(ct_params_t::opts, opts::dfl)) this->xchng_vctr_alng(this->GC_corr(iter));
-              }
-
-              this->fct_adjust_antidiff(e, iter);
-
-              // TODO: shouldn't the above halo-filling be repeated here?
+                calc_antidiff(e, iter,
+                  this->tile_faces(i, this->i), this->tile_faces(j, this->j), this->tile_faces(k, this->k),
+                  i, j, k
+                );
+              });
+              antidiff_post(e, iter);
             }
 
             const auto &i(this->i), &j(this->j), &k(this->k);
@@ -153,51 +176,233 @@ namespace libmpdataxx
             auto &GC(this->GC(iter));
             using namespace formulae::donorcell;
 
-            // calculation of fluxes
-            if (!opts::isset(ct_params_t::opts, opts::iga) || iter == 0)
+            if (iter == 0 && parent_t::xchng_in_advop)
             {
-              this->flux[0](im+h, j, k) = make_flux<ct_params_t::opts, 0>(psi[n], GC[0], im, j, k);
-              this->flux[1](i, jm+h, k) = make_flux<ct_params_t::opts, 1>(psi[n], GC[1], jm, k, i);
-              this->flux[2](i, j, km+h) = make_flux<ct_params_t::opts, 2>(psi[n], GC[2], km, i, j);
-              this->flux_ptr = &this->flux; // TODO: if !iga this is needed only once per simulation, TODO: move to common
+              donorcell_overlapped(e);
             }
             else
             {
-              assert(iter == 1); // infinite gauge option uses just one corrective step // TODO: not true?
-              this->flux_ptr = &GC;
+              // calculation of fluxes
+              if (!opts::isset(ct_params_t::opts, opts::iga) || iter == 0)
+              {
+                this->tiled(i, j, k, [&](const rng_t &ti, const rng_t &tj, const rng_t &tk)
+                {
+                  const rng_t tim = this->tile_faces(ti, i), tjm = this->tile_faces(tj, j), tkm = this->tile_faces(tk, k);
+                  this->flux[0](tim+h, tj, tk) = make_flux<ct_params_t::opts, 0>(psi[n], GC[0], tim, tj, tk);
+                  this->flux[1](ti, tjm+h, tk) = make_flux<ct_params_t::opts, 1>(psi[n], GC[1], tjm, tk, ti);
+                  this->flux[2](ti, tj, tkm+h) = make_flux<ct_params_t::opts, 2>(psi[n], GC[2], tkm, ti, tj);
+                });
+                this->flux_ptr = &this->flux; // TODO: if !iga this is needed only once per simulation, TODO: move to common
+              }
+              else
+              {
+                assert(iter == 1); // infinite gauge option uses just one corrective step // TODO: not true?
+                this->flux_ptr = &GC;
+              }
+
+              auto &flx = (*(this->flux_ptr));
+              this->xchng_flux(flx);
+
+              // sanity check for input
+              assert(std::isfinite(sum(psi[n](ijk))));
+              assert(std::isfinite(sum(flx[0](i^h, j,   k  ))));
+              assert(std::isfinite(sum(flx[1](i,   j^h, k  ))));
+              assert(std::isfinite(sum(flx[2](i,   j,   k^h))));
+
+              // donor-cell call
+              // TODO: doing antidiff,upstream,antidiff,upstream (for each dimension separately) could help optimise memory consumption!
+              this->tiled(i, j, k, [&](const rng_t &i, const rng_t &j, const rng_t &k)
+              {
+                const idx_t<3> ijk({i, j, k});
+                donorcell_sum<ct_params_t::opts>(
+                  this->mem->khn_tmp,
+                  ijk,
+                  psi[n+1](ijk),
+                  psi[n  ](ijk),
+                  flx[0](i+h, j,   k  ),
+                  flx[0](i-h, j,   k  ),
+                  flx[1](i,   j+h, k  ),
+                  flx[1](i,   j-h, k  ),
+                  flx[2](i,   j,   k+h),
+                  flx[2](i,   j,   k-h),
+                  formulae::G<ct_params_t::opts, 0>(*this->mem->G, i, j, k)
+                );
+              });
+            }
+
+            if (this->upwind_filter_freq > 0 && this->timestep % this->upwind_filter_freq == 0)
+            {
+              break;
+            }
+            // sanity check for output
+            assert(std::isfinite(sum(psi[n+1](ijk))));
+          }
+        }
+
+        // the first (donor-cell) iteration of advop() with the halos of psi filled while advecting the interior
+        // of the subdomain, i.e. all but its first and last planes in dimension 0, advected once the halos are filled
+        void donorcell_overlapped(int e)
+        {
+          const auto &i(this->i), &j(this->j), &k(this->k);
+          const auto &psi(this->mem->psi[e]);
+          const auto &n(this->n[e]);
+          auto &GC(this->GC(0));
+          auto &flx(this->flux);
+          using namespace formulae::donorcell;
+
+          this->flux_ptr = &this->flux;
+
+          auto fluxes = [&](const rng_t &ir)
+          {
+            this->tiled(ir, j, k, [&](const rng_t &ti, const rng_t &tj, const rng_t &tk)
+            {
+              const rng_t tim = this->tile_faces(ti, ir), tjm = this->tile_faces(tj, j), tkm = this->tile_faces(tk, k);
+              flx[0](tim+h, tj, tk) = make_flux<ct_params_t::opts, 0>(psi[n], GC[0], tim, tj, tk);
+              flx[1](ti, tjm+h, tk) = make_flux<ct_params_t::opts, 1>(psi[n], GC[1], tjm, tk, ti);
+              flx[2](ti, tj, tkm+h) = make_flux<ct_params_t::opts, 2>(psi[n], GC[2], tkm, ti, tj);
+            });
+            for (auto &bc : this->bcs[1]) bc->fill_halos_flux(flx, k, ir);
+            for (auto &bc : this->bcs[2]) bc->fill_halos_flux(flx, ir, j);
+          };
+
+          auto donorcell = [&](const rng_t &ir)
+          {
+            this->tiled(ir, j, k, [&](const rng_t &i, const rng_t &j, const rng_t &k)
+            {
+              const idx_t<3> ijk({i, j, k});
+              donorcell_sum<ct_params_t::opts>(
+                this->mem->khn_tmp,
+                ijk,
+                psi[n+1](ijk),
+                psi[n  ](ijk),
+                flx[0](i+h, j,   k  ),
+                flx[0](i-h, j,   k  ),
+                flx[1](i,   j+h, k  ),
+                flx[1](i,   j-h, k  ),
+                flx[2](i,   j,   k+h),
+                flx[2](i,   j,   k-h),
+                formulae::G<ct_params_t::opts, 0>(*this->mem->G, i, j, k)
+              );
+            });
+          };
+
+          this->start_xchng_sclr(this->mem->psi[e][n], this->ijk, this->halo);
+
+          // sanity check for input
+          assert(std::isfinite(sum(psi[n](this->ijk))));
+
+          if (i.last() - i.first() > 1)
+          {
+            const rng_t ii(i.first() + 1, i.last() - 1);
+            fluxes(ii);
+            donorcell(ii);
+          }
+
+          this->finish_xchng_sclr(this->mem->psi[e][n], this->ijk, this->halo);
+
+          const rng_t il(i.first(), i.first()), ir(i.last(), i.last());
+          fluxes(il);
+          if (i.last() != i.first()) fluxes(ir);
+          for (auto &bc : this->bcs[0]) bc->fill_halos_flux(flx, j, k);
+          donorcell(il);
+          if (i.last() != i.first()) donorcell(ir);
+        }
+
+        // default tile sizes used by the fused kernel if none set in rt_params_t
+        // (the k dimension, contiguous in memory, is not split)
+        enum { fused_blk_i = 4, fused_blk_j = 16 };
+
+        // fused version of advop(): antidiffusive velocities, fluxes and the donor-cell update
+        // are computed block by block so that psi, GC and flux are reused while still in cache;
+        // antidiffusive velocities are calculated in a separate sweep if a global step
+        // (fct limiting, dfl halo-filling, time-level barrier for div_3rd_dt) has to be done before the fluxes
+        void advop_fused(int e)
+        {
+          constexpr bool fuse_antidiff = !opts::isset(ct_params_t::opts, opts::fct)
+                                      && !opts::isset(ct_params_t::opts, opts::dfl)
+                                      && !opts::isset(ct_params_t::opts, opts::div_3rd_dt);
+
+          this->fct_init(e);
+
+          for (int iter = 0; iter < this->n_iters; ++iter)
+          {
+            if (iter != 0)
+            {
+              this->cycle(e);
+              this->xchng(e);
+
+              if (!fuse_antidiff)
+              {
+                calc_antidiff(e, iter, this->im, this->jm, this->km, this->i, this->j, this->k);
+                antidiff_post(e, iter);
+              }
             }
 
+            const auto &psi(this->mem->psi[e]);
+            const auto &n(this->n[e]);
+            auto &GC(this->GC(iter));
+            using namespace formulae::donorcell;
+
+            const bool calc_flux = !opts::isset(ct_params_t::opts, opts::iga) || iter == 0;
+            assert(calc_flux || iter == 1); // infinite gauge option uses just one corrective step
+            this->flux_ptr = calc_flux ? &this->flux : &GC;
             auto &flx = (*(this->flux_ptr));
-            this->xchng_flux(flx);
 
             // sanity check for input
-            assert(std::isfinite(sum(psi[n](ijk))));
-            assert(std::isfinite(sum(flx[0](i^h, j,   k  ))));
-            assert(std::isfinite(sum(flx[1](i,   j^h, k  ))));
-            assert(std::isfinite(sum(flx[2](i,   j,   k^h))));
-
-            // donor-cell call
-            // TODO: doing antidiff,upstream,antidiff,upstream (for each dimension separately) could help optimise memory consumption!
-            donorcell_sum<ct_params_t::opts>(
-              this->mem->khn_tmp,
-              ijk,
-              psi[n+1](ijk),
-              psi[n  ](ijk),
-              flx[0](i+h, j,   k  ),
-              flx[0](i-h, j,   k  ),
-              flx[1](i,   j+h, k  ),
-              flx[1](i,   j-h, k  ),
-              flx[2](i,   j,   k+h),
-              flx[2](i,   j,   k-h),
-              formulae::G<ct_params_t::opts, 0>(*this->mem->G, i, j, k)
-            );
+            assert(std::isfinite(sum(psi[n](this->ijk))));
+
+            const std::array<int, 3> ts = (this->tile_size[0] > 0 || this->tile_size[1] > 0 || this->tile_size[2] > 0)
+              ? this->tile_size
+              : std::array<int, 3>({{fused_blk_i, fused_blk_j, 0}});
+
+            this->tiled(ts, this->i, this->j, this->k, [&](const rng_t &i, const rng_t &j, const rng_t &k)
+            {
+              const idx_t<3> ijk({i, j, k});
+              const rng_t
+                im = this->tile_faces(i, this->i),
+                jm = this->tile_faces(j, this->j),
+                km = this->tile_faces(k, this->k);
+
+              if (fuse_antidiff && iter != 0) calc_antidiff(e, iter, im, jm, km, i, j, k);
+
+              if (calc_flux)
+              {
+                this->flux[0](im+h, j, k) = make_flux<ct_params_t::opts, 0>(psi[n], GC[0], im, j, k);
+                this->flux[1](i, jm+h, k) = make_flux<ct_params_t::opts, 1>(psi[n], GC[1], jm, k, i);
+                this->flux[2](i, j, km+h) = make_flux<ct_params_t::opts, 2>(psi[n], GC[2], km, i, j);
+              }
+
+              // flux halos (only nontrivial for rigid bconds) for tiles touching subdomain edges
+              if (i.first() == this->i.first() || i.last() == this->i.last())
+                for (auto &bc : this->bcs[0]) bc->fill_halos_flux(flx, j, k);
+              if (j.first() == this->j.first() || j.last() == this->j.last())
+                for (auto &bc : this->bcs[1]) bc->fill_halos_flux(flx, k, i);
+              if (k.first() == this->k.first() || k.last() == this->k.last())
+                for (auto &bc : this->bcs[2]) bc->fill_halos_flux(flx, i, j);
+
+              donorcell_sum<ct_params_t::opts>(
+                this->mem->khn_tmp,
+                ijk,
+                psi[n+1](ijk),
+                psi[n  ](ijk),
+                flx[0](i+h, j,   k  ),
+                flx[0](i-h, j,   k  ),
+                flx[1](i,   j+h, k  ),
+                flx[1](i,   j-h, k  ),
+                flx[2](i,   j,   k+h),
+                flx[2](i,   j,   k-h),
+                formulae::G<ct_params_t::opts, 0>(*this->mem->G, i, j, k)
+              );
+            });
+
+            if (fuse_antidiff && iter != 0) antidiff_post(e, iter);
 
             if (this->upwind_filter_freq > 0 && this->timestep % this->upwind_filter_freq == 0)
             {
               break;
             }
             // sanity check for output
-            assert(std::isfinite(sum(psi[n+1](ijk))));
+            assert(std::isfinite(sum(psi[n+1](this->ijk))));
           }
         }
 
@@ -232,6 +232,7 @@ namespace libmpdataxx
           {
             vips()[d](this->ijk) += real_t(0.5) * this->dt * vip_rhs[d](this->ijk);
             vip_rhs[d](this->ijk) = 0;
+            this->invalidate_halo(vip_ixs[d]);
           }
         }
 
@@ -242,6 +243,7 @@ namespace libmpdataxx
             for (int d = 0; d < parent_t::n_dims; ++d)
             {
               v[d](this->ijk) /= (1 + real_t(0.5) * this->dt * (*this->mem->vab_coeff)(this->ijk));
+              this->invalidate_halo(vip_ixs[d]); // v might be vips()
             }
           }
         }
@@ -252,6 +254,7 @@ namespace libmpdataxx
           {
             this->vips()[d](this->ijk) +=
               real_t(0.5) * this->dt * (*this->mem->vab_coeff)(this->ijk) * this->mem->vab_relax[d](this->ijk);
+            this->invalidate_halo(vip_ixs[d]);
           }
         }
 
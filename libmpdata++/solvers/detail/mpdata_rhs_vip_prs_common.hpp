@@ -47,15 +47,20 @@ namespace libmpdataxx
           return this->mem->sum(this->rank, arr1, arr2, ijk, ct_params_t::prs_khn);
         }
 
-        auto lap(
+        // gradient of arr (normalised unless simple) which divergence is the Laplacian returned by lap_div()
+        void lap_grad(
           arr_t &arr,
           const ijk_t &ijk,
           const std::array<real_t, parent_t::n_dims>& dijk,
           bool err_init, // if true then subtract initial state for error calculation
           bool simple // if true do not normalize gradients (simple laplacian)
-        ) return_macro(
+        )
+        {
           this->xchng_pres(arr, ijk);
-          formulae::nabla::calc_grad<parent_t::n_dims>(lap_tmp, arr, ijk, dijk);
+          this->tiled(ijk, [&](const ijk_t &t)
+          {
+            formulae::nabla::calc_grad<parent_t::n_dims>(lap_tmp, arr, t, dijk);
+          });
           if (err_init)
           {
             for (int d = 0; d < parent_t::n_dims; ++d)
@@ -76,9 +81,29 @@ namespace libmpdataxx
           {
             this->xchng_pres(lap_tmp[d], ijk);
           }
+        }
+
+        // Laplacian of the field passed to the preceding lap_grad() call, to be evaluated
+        // over a tile t of ijk (see solver_common::tiled())
+        auto lap_div(
+          const ijk_t &t,
+          const std::array<real_t, parent_t::n_dims>& dijk
+        ) return_macro(
           ,
-          formulae::nabla::div<parent_t::n_dims>(lap_tmp, ijk, dijk)
-          / formulae::G<ct_params_t::opts>(*this->mem->G, this->ijk)
+          formulae::nabla::div<parent_t::n_dims>(lap_tmp, t, dijk)
+          / formulae::G<ct_params_t::opts>(*this->mem->G, t)
+        )
+
+        auto lap(
+          arr_t &arr,
+          const ijk_t &ijk,
+          const std::array<real_t, parent_t::n_dims>& dijk,
+          bool err_init, // if true then subtract initial state for error calculation
+          bool simple // if true do not normalize gradients (simple laplacian)
+        ) return_macro(
+          lap_grad(arr, ijk, dijk, err_init, simple);
+          ,
+          lap_div(this->ijk, dijk)
         )
 
         void ini_pressure()
@@ -106,7 +131,8 @@ namespace libmpdataxx
           }
 
           //initial error
-          err(this->ijk) = lap(Phi, this->ijk, this->dijk, true, simple);
+          lap_grad(Phi, this->ijk, this->dijk, true, simple);
+          this->tiled(this->ijk, [&](const ijk_t &t) { err(t) = lap_div(t, this->dijk); });
 
           iters = 0;
           converged = false;
@@ -127,7 +153,10 @@ namespace libmpdataxx
 
           this->xchng_pres(this->Phi, this->ijk);
 
-          formulae::nabla::calc_grad<parent_t::n_dims>(tmp_uvw, Phi, this->ijk, this->dijk);
+          this->tiled(this->ijk, [&](const ijk_t &t)
+          {
+            formulae::nabla::calc_grad<parent_t::n_dims>(tmp_uvw, Phi, t, this->dijk);
+          });
         }
 
         void pressure_solver_apply()
@@ -135,6 +164,7 @@ namespace libmpdataxx
           for (int d = 0; d < parent_t::n_dims; ++d)
           {
             this->vips()[d](this->ijk) -= tmp_uvw[d](this->ijk);
+            this->invalidate_halo(this->vip_ixs[d]);
           }
         }
 
@@ -150,7 +180,10 @@ namespace libmpdataxx
           pressure_solver_update(true);
 
           this->xchng_pres(this->Phi, this->ijk);
-          formulae::nabla::calc_grad<parent_t::n_dims>(tmp_uvw, Phi, this->ijk, this->dijk);
+          this->tiled(this->ijk, [&](const ijk_t &t)
+          {
+            formulae::nabla::calc_grad<parent_t::n_dims>(tmp_uvw, Phi, t, this->dijk);
+          });
           pressure_solver_apply();
           this->set_edges(this->vips(), this->ijk, 1);
 
@@ -161,7 +194,10 @@ namespace libmpdataxx
 
           // allow pressure_solver_apply at the first time step
           this->xchng_pres(this->Phi, this->ijk);
-          formulae::nabla::calc_grad<parent_t::n_dims>(tmp_uvw, Phi, this->ijk, this->dijk);
+          this->tiled(this->ijk, [&](const ijk_t &t)
+          {
+            formulae::nabla::calc_grad<parent_t::n_dims>(tmp_uvw, Phi, t, this->dijk);
+          });
           for (int d = 0; d < parent_t::n_dims; ++d)
           {
             this->vip_rhs[d](this->ijk) -= tmp_uvw[d](this->ijk);
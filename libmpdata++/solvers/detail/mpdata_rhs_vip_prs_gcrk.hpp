@@ -39,7 +39,8 @@ namespace libmpdataxx
         void pressure_solver_loop_init(bool simple) final
         {
           p_err[0](this->ijk) = this->err(this->ijk);
-          lap_p_err[0](this->ijk) = this->lap(p_err[0], this->ijk, this->dijk, false, simple);
+          this->lap_grad(p_err[0], this->ijk, this->dijk, false, simple);
+          this->tiled(this->ijk, [&](const idx_t<ct_params_t::n_dims> &t) { lap_p_err[0](t) = this->lap_div(t, this->dijk); });
         }
 
         void pressure_solver_loop_body(bool simple) final
@@ -58,7 +59,8 @@ namespace libmpdataxx
 
             if (error <= this->err_tol) this->converged = true;
 
-            lap_err(this->ijk) = this->lap(this->err, this->ijk, this->dijk, false, simple);
+            this->lap_grad(this->err, this->ijk, this->dijk, false, simple);
+            this->tiled(this->ijk, [&](const idx_t<ct_params_t::n_dims> &t) { lap_err(t) = this->lap_div(t, this->dijk); });
 
             for (int l = 0; l <= v; ++l)
             {
@@ -114,9 +116,9 @@ namespace libmpdataxx
           const int &n_iters
         ) {
           parent_t::alloc(mem, n_iters);
-          parent_t::alloc_tmp_sclr(mem, __FILE__, 1);
-          parent_t::alloc_tmp_sclr(mem, __FILE__, k_iters);
-          parent_t::alloc_tmp_sclr(mem, __FILE__, k_iters);
+          parent_t::alloc_tmp_sclr(mem, __FILE__, 1, "", false, tmp_phase::pressure);       // lap_err
+          parent_t::alloc_tmp_sclr(mem, __FILE__, k_iters, "", false, tmp_phase::pressure); // lap_p_err
+          parent_t::alloc_tmp_sclr(mem, __FILE__, k_iters, "", false, tmp_phase::pressure); // p_err
         }
       };
     } // namespace detail
@@ -39,7 +39,8 @@ namespace libmpdataxx
 
         void pressure_solver_loop_body(bool simple) final
         {
-          this->lap_err(this->ijk) = this->lap(this->err, this->ijk, this->dijk, false, simple);
+          this->lap_grad(this->err, this->ijk, this->dijk, false, simple);
+          this->tiled(this->ijk, [&](const idx_t<ct_params_t::n_dims> &t) { this->lap_err(t) = this->lap_div(t, this->dijk); });
 
           tmp_den = this->prs_sum(this->lap_err, this->lap_err, this->ijk);
           if (tmp_den != 0) beta = - this->prs_sum(this->err, this->lap_err, this->ijk) / tmp_den;
@@ -75,7 +76,7 @@ namespace libmpdataxx
           const int &n_iters
         ) {
           parent_t::alloc(mem, n_iters);
-          parent_t::alloc_tmp_sclr(mem, __FILE__, 1);
+          parent_t::alloc_tmp_sclr(mem, __FILE__, 1, "", false, tmp_phase::pressure); // lap_err
         }
       };
     } // namespace detail
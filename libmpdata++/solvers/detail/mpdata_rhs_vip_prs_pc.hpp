@@ -43,14 +43,16 @@ namespace libmpdataxx
           q_err(this->ijk) = real_t(0);
 
           //initail preconditioner error
-          this->pcnd_err(this->ijk) = this->lap(this->q_err, this->ijk, this->dijk, false, simple) - this->err(this->ijk);
+          this->lap_grad(this->q_err, this->ijk, this->dijk, false, simple);
+          this->tiled(this->ijk, [&](const idx_t<ct_params_t::n_dims> &t) { this->pcnd_err(t) = this->lap_div(t, this->dijk) - this->err(t); });
             //TODO does it change with non_const density?
 
           assert(pc_iters >= 0 && pc_iters < 10 && "params.pc_iters not specified?");
           for (int it=0; it<=pc_iters; it++)
           {
             q_err(this->ijk)    += real_t(.25) * pcnd_err(this->ijk);
-            pcnd_err(this->ijk) += real_t(.25) * this->lap(this->pcnd_err, this->ijk, this->dijk);
+            this->lap_grad(this->pcnd_err, this->ijk, this->dijk);
+            this->tiled(this->ijk, [&](const idx_t<ct_params_t::n_dims> &t) { pcnd_err(t) += real_t(.25) * this->lap_div(t, this->dijk); });
           }
         }
 
@@ -58,7 +60,8 @@ namespace libmpdataxx
         {
           precond(simple);
           p_err(this->ijk) = q_err(this->ijk);
-          this->lap_p_err(this->ijk) = this->lap(this->p_err, this->ijk, this->dijk, false, simple);
+          this->lap_grad(this->p_err, this->ijk, this->dijk, false, simple);
+          this->tiled(this->ijk, [&](const idx_t<ct_params_t::n_dims> &t) { this->lap_p_err(t) = this->lap_div(t, this->dijk); });
         }
 
         void pressure_solver_loop_body(bool simple) final
@@ -78,7 +81,8 @@ namespace libmpdataxx
 
           precond();
 
-          this->lap_q_err(this->ijk) = this->lap(this->q_err, this->ijk, this->dijk, false, simple);
+          this->lap_grad(this->q_err, this->ijk, this->dijk, false, simple);
+          this->tiled(this->ijk, [&](const idx_t<ct_params_t::n_dims> &t) { this->lap_q_err(t) = this->lap_div(t, this->dijk); });
 
           if (tmp_den != 0) alpha = -this->prs_sum(lap_q_err, lap_p_err, this->ijk) / tmp_den;
 
@@ -115,7 +119,7 @@ namespace libmpdataxx
           const int &n_iters
         ) {
           parent_t::alloc(mem, n_iters);
-          parent_t::alloc_tmp_sclr(mem, __FILE__, 5);
+          parent_t::alloc_tmp_sclr(mem, __FILE__, 5, "", false, tmp_phase::pressure);
         }
       };
     } // namespcae detail
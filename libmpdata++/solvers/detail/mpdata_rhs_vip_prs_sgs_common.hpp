@@ -57,7 +57,7 @@ namespace libmpdataxx
         // ijkm with non-overlapping ranges
         idx_t<ct_params_t::n_dims> ijkm_sep;
 
-        // like ijk, but with range in x direction extended by 1 to the left for rank=0 for MPI compliance.
+        // like ijk, but with range in x direction (and in the other directions split between processes) extended by 1 to the left for the leftmost threads for MPI compliance.
         // MPI requires that vector between two process domains is calculated by the process to the right of it  (c.f. remote_2d.hpp fill_halos_vctr_alng)
         // TODO: change MPI logic to assume that it is calculated by the process to the left? then, ijk_vec would not be needed(?)
         std::array<rng_t, ct_params_t::n_dims> ijk_vec;
@@ -83,7 +83,10 @@ namespace libmpdataxx
           for (int m = 0; m < 3; ++m)
           {
             this->xchng_sclr(wrk[0], this->ijk);
-            formulae::stress::pade_dispatch<ct_params_t::n_dims>(wrk, this->ijk, d);
+            this->tiled(this->ijk, [&](const idx_t<ct_params_t::n_dims> &t)
+            {
+              formulae::stress::pade_dispatch<ct_params_t::n_dims>(wrk, t, d);
+            });
             // finish calculation of wrk[1] before modyfying wrk[0]
             this->mem->barrier();
             wrk[0](this->ijk) += (drv[d](this->ijk) - real_t(0.25) * wrk[1](this->ijk));
@@ -101,7 +104,7 @@ namespace libmpdataxx
           using ix = typename ct_params_t::ix;
           using namespace arakawa_c;
 
-          // TODO: get rid of superfluous barriers
+          // skipped if the halos are still valid (see solver_common::halo_valid())
           for (auto& vip : this->vips())
             this->xchng_sclr(vip, this->ijk, 1);
 
@@ -111,7 +114,10 @@ namespace libmpdataxx
 
             if (this->mem->G)
             {
-              formulae::stress::calc_vip_div_cmpct<ct_params_t::n_dims>(vip_div, this->vips(), *this->mem->G, this->ijk, this->dijk);
+              this->tiled(this->ijk, [&](const idx_t<ct_params_t::n_dims> &t)
+              {
+                formulae::stress::calc_vip_div_cmpct<ct_params_t::n_dims>(vip_div, this->vips(), *this->mem->G, t, this->dijk);
+              });
               this->xchng_sgs_div(vip_div, this->ijk);
             }
             else
@@ -121,7 +127,10 @@ namespace libmpdataxx
               this->xchng_sgs_div(vip_div, this->ijk);
             }
 
-            formulae::stress::calc_deform_cmpct<ct_params_t::n_dims>(tau, this->vips(), vip_div, this->ijk, ijkm, this->dijk);
+            this->tiled(this->ijk, [&](const idx_t<ct_params_t::n_dims> &t)
+            {
+              formulae::stress::calc_deform_cmpct<ct_params_t::n_dims>(tau, this->vips(), vip_div, t, this->tile_faces(t, this->ijk, ijkm), this->dijk);
+            });
 
             this->xchng_sgs_tnsr_diag(tau, this->vips()[ct_params_t::n_dims - 1], vip_div, this->ijk);
             this->xchng_sgs_tnsr_offdiag(tau, tau_srfc, this->ijk, this->ijkm);
@@ -130,17 +139,23 @@ namespace libmpdataxx
             multiply_sgs_visc();
 
             // update forces
-            formulae::stress::calc_stress_rhs_cmpct<ct_params_t::n_dims, ct_params_t::opts>(this->vip_rhs,
-                                                                                            tau,
-                                                                                            *this->mem->G,
-                                                                                            this->ijk,
-                                                                                            this->dijk,
-                                                                                            real_t(2.0));
+            this->tiled(this->ijk, [&](const idx_t<ct_params_t::n_dims> &t)
+            {
+              formulae::stress::calc_stress_rhs_cmpct<ct_params_t::n_dims, ct_params_t::opts>(this->vip_rhs,
+                                                                                              tau,
+                                                                                              *this->mem->G,
+                                                                                              t,
+                                                                                              this->dijk,
+                                                                                              real_t(2.0));
+            });
           }
           else
           {
             // calculate velocity gradient tensor
-            formulae::stress::calc_vgrad<ct_params_t::n_dims>(drv, this->vips(), this->ijk, this->dijk);
+            this->tiled(this->ijk, [&](const idx_t<ct_params_t::n_dims> &t)
+            {
+              formulae::stress::calc_vgrad<ct_params_t::n_dims>(drv, this->vips(), t, this->dijk);
+            });
 
             // optionally correct derivatives using Pade scheme
             if ((stress_diff_t)ct_params_t::stress_diff == pade)
@@ -150,7 +165,10 @@ namespace libmpdataxx
             }
 
             // calculate independent components of deformation tensor
-            formulae::stress::calc_deform<ct_params_t::n_dims>(tau, drv, this->ijk);
+            this->tiled(this->ijk, [&](const idx_t<ct_params_t::n_dims> &t)
+            {
+              formulae::stress::calc_deform<ct_params_t::n_dims>(tau, drv, t);
+            });
 
             // multiply deformation tensor by sgs viscosity to obtain stress tensor
             multiply_sgs_visc();
@@ -161,7 +179,10 @@ namespace libmpdataxx
               this->xchng_sclr(t, this->ijk);
             }
             // calculate elements of stress tensor divergence
-            formulae::stress::calc_stress_div<ct_params_t::n_dims>(drv, tau, this->ijk, this->dijk);
+            this->tiled(this->ijk, [&](const idx_t<ct_params_t::n_dims> &t)
+            {
+              formulae::stress::calc_stress_div<ct_params_t::n_dims>(drv, tau, t, this->dijk);
+            });
 
             // optionally correct derivatives using Pade scheme
             if ((stress_diff_t)ct_params_t::stress_diff == pade)
@@ -171,7 +192,10 @@ namespace libmpdataxx
             }
 
             // update forces
-            formulae::stress::calc_stress_rhs<ct_params_t::n_dims>(this->vip_rhs, drv, this->ijk, real_t(2.0));
+            this->tiled(this->ijk, [&](const idx_t<ct_params_t::n_dims> &t)
+            {
+              formulae::stress::calc_stress_rhs<ct_params_t::n_dims>(this->vip_rhs, drv, t, real_t(2.0));
+            });
           }
         }
 
@@ -201,15 +225,20 @@ namespace libmpdataxx
             ijkm.ubound()(d) = this->ijk[d].last();
 
             ijk_vec[d] = rng_t(this->ijk[d].first(),     this->ijk[d].last());
+
+            // in dimensions other than 0 only by the processes not at the left edge of the domain
+            if (this->mem->thrd_crd(this->rank, d) == 0 && (d == 0 || this->mem->distmem.coords[d] > 0))
+              ijk_vec[d] = rng_t(this->ijk[d].first() - 1, this->ijk[d].last());
           }
-          if (this->rank == 0)
-            ijk_vec[0] = rng_t(this->ijk[0].first() - 1, this->ijk[0].last());
 
           ijkm_sep = ijkm;
-          if (this->rank > 0)
+          for (int d = 0; d < ct_params_t::n_dims; ++d)
           {
-            ijkm_sep.lbound()(0) = this->ijk[0].first();
-            ijkm_sep.ubound()(0) = this->ijk[0].last();
+            if (this->mem->thrd_crd(this->rank, d) > 0)
+            {
+              ijkm_sep.lbound()(d) = this->ijk[d].first();
+              ijkm_sep.ubound()(d) = this->ijk[d].last();
+            }
           }
         }
 
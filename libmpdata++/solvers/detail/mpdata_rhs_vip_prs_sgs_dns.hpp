@@ -27,7 +27,10 @@ namespace libmpdataxx
         {
           if (static_cast<stress_diff_t>(ct_params_t::stress_diff) == compact)
           {
-            formulae::stress::multiply_tnsr_cmpct<ct_params_t::n_dims>(this->tau, eta, this->ijkm_sep);
+            this->tiled(this->ijkm_sep, [&](const idx_t<ct_params_t::n_dims> &t)
+            {
+              formulae::stress::multiply_tnsr_cmpct<ct_params_t::n_dims>(this->tau, eta, t);
+            });
 
             this->xchng_sgs_tnsr_diag(this->tau, this->vips()[ct_params_t::n_dims - 1], this->vip_div, this->ijk);
             this->xchng_sgs_tnsr_offdiag(this->tau, this->tau_srfc, this->ijk, this->ijkm);
@@ -34,20 +34,29 @@ namespace libmpdataxx
 
           if (static_cast<stress_diff_t>(ct_params_t::stress_diff) == compact)
           {
-            k_m(this->ijk) = pow(smg_c * dlta, 2) * formulae::stress::calc_tdef_sq_cmpct<ct_params_t::n_dims>(this->tau, this->ijk);
+            this->tiled(this->ijk, [&](const idx_t<ct_params_t::n_dims> &t)
+            {
+              k_m(t) = pow(smg_c * dlta, 2) * formulae::stress::calc_tdef_sq_cmpct<ct_params_t::n_dims>(this->tau, t);
+            });
 
-            formulae::stress::multiply_tnsr_cmpct<ct_params_t::n_dims, ct_params_t::opts>(this->tau,
-                                                                                          real_t(1.0),
-                                                                                          this->k_m,
-                                                                                          *this->mem->G,
-                                                                                          this->ijkm_sep);
+            this->tiled(this->ijkm_sep, [&](const idx_t<ct_params_t::n_dims> &t)
+            {
+              formulae::stress::multiply_tnsr_cmpct<ct_params_t::n_dims, ct_params_t::opts>(this->tau,
+                                                                                            real_t(1.0),
+                                                                                            this->k_m,
+                                                                                            *this->mem->G,
+                                                                                            t);
+            });
 
             this->xchng_sgs_tnsr_diag(this->tau, this->vips()[ct_params_t::n_dims - 1], this->vip_div, this->ijk);
             this->xchng_sgs_tnsr_offdiag(this->tau, this->tau_srfc, this->ijk, this->ijkm);
           }
           else
           {
-            k_m(this->ijk) = pow(smg_c * dlta, 2) *  formulae::stress::calc_tdef_sq<ct_params_t::n_dims>(this->tau, this->ijk);
+            this->tiled(this->ijk, [&](const idx_t<ct_params_t::n_dims> &t)
+            {
+              k_m(t) = pow(smg_c * dlta, 2) * formulae::stress::calc_tdef_sq<ct_params_t::n_dims>(this->tau, t);
+            });
 
             for (auto& t : this->tau)
             {
@@ -38,9 +38,12 @@ namespace libmpdataxx
 
         virtual void xchng_sclr(typename parent_t::arr_t &arr, const bool deriv = false) final // for a given array
         {
-          this->mem->barrier();
-          for (auto &bc : this->bcs[0]) bc->fill_halos_sclr(arr, deriv);
-          this->mem->barrier();
+          this->xchng_tracked(arr, this->ijk, this->halo, deriv, [&]()
+          {
+            this->mem->barrier();
+            for (auto &bc : this->bcs[0]) bc->fill_halos_sclr(arr, deriv);
+            this->mem->barrier();
+          });
         }
 
         // no pressure solver in 1D but this function needs to be present for dimension independant code,
@@ -74,6 +77,7 @@ namespace libmpdataxx
           this->mem->barrier();
           for (auto &bc : this->bcs[0]) bc->copy_edge_sclr_to_halo1_cyclic(arr);
           for (auto &bc : this->bcs[0]) bc->avg_edge_and_halo1_sclr_cyclic(arr);
+          this->invalidate_halo(arr);
           this->mem->barrier();
         }
 
@@ -144,7 +148,8 @@ namespace libmpdataxx
           const char * __file__,
           const int n_arr,
           const rng_t rng,
-          std::string name = ""
+          std::string name = "",
+          const int phase = tmp_phase::all
         )
         {
           mem->tmp[__file__].push_back(new arrvec_t<typename parent_t::arr_t>());
@@ -154,7 +159,7 @@ namespace libmpdataxx
           for (int n = 0; n < n_arr; ++n)
           {
             mem->tmp[__file__].back().push_back(
-              mem->old(new typename parent_t::arr_t( rng ))
+              mem->old(new typename parent_t::arr_t( rng ), phase)
             );
           }
         }
@@ -170,6 +175,9 @@ namespace libmpdataxx
             for (int n = 0; n < n_tlev; ++n) // time levels
               mem->psi[e].push_back(mem->old(new typename parent_t::arr_t(parent_t::rng_sclr(mem->grid_size[0]))));
 
+          // storage shared between phases sized to fit both scalars and vector components
+          mem->tmp_slot_size = mem->psi[0][0].numElements();
+
           mem->GC.push_back(mem->old(new typename parent_t::arr_t(parent_t::rng_vctr(mem->grid_size[0]))));
 
           // fully third-order accurate mpdata needs also time derivatives of
@@ -201,19 +209,23 @@ namespace libmpdataxx
         // helper method to allocate a vector-component temporary array
         static void alloc_tmp_vctr(
           typename parent_t::mem_t *mem,
-          const char * __file__
+          const char * __file__,
+          const int phase = tmp_phase::all
         )
         {
-          alloc_tmp(mem, __file__, 1, parent_t::rng_vctr(mem->grid_size[0])); // always one-component vectors
+          alloc_tmp(mem, __file__, 1, parent_t::rng_vctr(mem->grid_size[0]), "", phase); // always one-component vectors
         }
 
         // helper method to allocate n_arr scalar temporary arrays
         static void alloc_tmp_sclr(
           typename parent_t::mem_t *mem,
-          const char * __file__, const int n_arr
+          const char * __file__, const int n_arr,
+          std::string name = "",
+          bool srfc = false, // unused in 1D, for signature compatibility with 2D and 3D
+          const int phase = tmp_phase::all
         )
         {
-          alloc_tmp(mem, __file__, n_arr, parent_t::rng_sclr(mem->grid_size[0]));
+          alloc_tmp(mem, __file__, n_arr, parent_t::rng_sclr(mem->grid_size[0]), name, phase);
         }
       };
     } // namespace detail
@@ -43,11 +43,16 @@ namespace libmpdataxx
                         const bool deriv = false
         ) final // for a given array
         {
-          const auto range_ijk_0__ext = this->extend_range(range_ijk[0], ext);
-          this->mem->barrier();
-          for (auto &bc : this->bcs[0]) bc->fill_halos_sclr(arr, range_ijk[1]^ext, deriv);
-          for (auto &bc : this->bcs[1]) bc->fill_halos_sclr(arr, range_ijk_0__ext, deriv);
-          this->mem->barrier();
+          this->xchng_tracked(arr, range_ijk, ext, deriv, [&]()
+          {
+            const auto range_ijk_0__ext = this->extend_range(0, range_ijk[0], ext);
+            const auto range_ijk_1__ext = this->extend_range(1, range_ijk[1], ext);
+            this->mem->barrier();
+            for (auto &bc : this->bcs[0]) bc->fill_halos_sclr(arr, range_ijk_1__ext, deriv);
+            this->corner_barrier();
+            for (auto &bc : this->bcs[1]) bc->fill_halos_sclr(arr, range_ijk_0__ext, deriv);
+            this->mem->barrier();
+          });
         }
 
         void xchng(int e) final
@@ -87,6 +92,7 @@ namespace libmpdataxx
         {
           this->mem->barrier();
           for (auto &bc : this->bcs[1]) bc->fill_halos_sgs_div(arr, range_ijk[0]);
+          this->corner_barrier();
           for (auto &bc : this->bcs[0]) bc->fill_halos_sgs_div(arr, range_ijk[1]^h);
           this->mem->barrier();
         }
@@ -136,17 +142,18 @@ namespace libmpdataxx
         ) final
         {
 
-          const auto range_ijk_0__ext_h = this->extend_range(range_ijk[0], ext, h);
+          const auto range_ijk_0__ext_h = this->extend_range(0, range_ijk[0], ext, h);
+          const auto range_ijk_1__ext_h = this->extend_range(1, range_ijk[1], ext, h);
           this->mem->barrier();
           if (!cyclic)
           {
             for (auto &bc : this->bcs[1]) bc->fill_halos_vctr_nrml(arrvec[0], range_ijk_0__ext_h);
-            for (auto &bc : this->bcs[0]) bc->fill_halos_vctr_nrml(arrvec[1], range_ijk[1]^ext^h);
+            for (auto &bc : this->bcs[0]) bc->fill_halos_vctr_nrml(arrvec[1], range_ijk_1__ext_h);
           }
           else
           {
             for (auto &bc : this->bcs[1]) bc->fill_halos_vctr_nrml_cyclic(arrvec[0], range_ijk_0__ext_h);
-            for (auto &bc : this->bcs[0]) bc->fill_halos_vctr_nrml_cyclic(arrvec[1], range_ijk[1]^ext^h);
+            for (auto &bc : this->bcs[0]) bc->fill_halos_vctr_nrml_cyclic(arrvec[1], range_ijk_1__ext_h);
           }
           this->mem->barrier();
         }
@@ -157,10 +164,13 @@ namespace libmpdataxx
           const int ext = 0
         ) final
         {
-          const auto range_ijk_0__ext = this->extend_range(range_ijk[0], ext);
+          const auto range_ijk_0__ext = this->extend_range(0, range_ijk[0], ext);
+          const auto range_ijk_1__ext = this->extend_range(1, range_ijk[1], ext);
           this->mem->barrier();
-          for (auto &bc : this->bcs[0]) bc->fill_halos_pres(arr, range_ijk[1]^ext);
+          for (auto &bc : this->bcs[0]) bc->fill_halos_pres(arr, range_ijk_1__ext);
+          this->corner_barrier();
           for (auto &bc : this->bcs[1]) bc->fill_halos_pres(arr, range_ijk_0__ext);
+          this->invalidate_halo(arr); // not the halo of xchng_sclr()
           this->mem->barrier();
         }
 
@@ -172,6 +182,7 @@ namespace libmpdataxx
         {
           for (auto &bc : this->bcs[0]) bc->set_edge_pres(av[0], range_ijk[1], sign);
           for (auto &bc : this->bcs[1]) bc->set_edge_pres(av[1], range_ijk[0], sign);
+          for (int d = 0; d < 2; ++d) this->invalidate_halo(av[d]);
           this->mem->barrier();
         }
 
@@ -192,9 +203,11 @@ namespace libmpdataxx
           this->mem->barrier();
           for (auto &bc : this->bcs[0]) bc->copy_edge_sclr_to_halo1_cyclic(arr, range_ijk[1]);
           for (auto &bc : this->bcs[0]) bc->avg_edge_and_halo1_sclr_cyclic(arr, range_ijk[1]);
+          this->corner_barrier();
 
           for (auto &bc : this->bcs[1]) bc->copy_edge_sclr_to_halo1_cyclic(arr, range_ijk[0]);
           for (auto &bc : this->bcs[1]) bc->avg_edge_and_halo1_sclr_cyclic(arr, range_ijk[0]);
+          this->invalidate_halo(arr);
           this->mem->barrier();
         }
 
@@ -302,6 +315,9 @@ namespace libmpdataxx
                 parent_t::rng_sclr(mem->grid_size[1])
               )));
 
+          // storage shared between phases sized to fit both scalars and vector components
+          mem->tmp_slot_size = mem->psi[0][0].numElements();
+
           // Courant field components (Arakawa-C grid)
           mem->GC.push_back(mem->old(new typename parent_t::arr_t(
             parent_t::rng_vctr(mem->grid_size[0]),
@@ -362,7 +378,8 @@ namespace libmpdataxx
           const char * __file__,
           const int n_arr,
           const std::vector<std::vector<bool>> &stgr,
-          bool srfc = false
+          bool srfc = false,
+          const int phase = tmp_phase::all
         )
         {
           mem->tmp[__file__].push_back(new arrvec_t<typename parent_t::arr_t>());
@@ -373,17 +390,18 @@ namespace libmpdataxx
               srfc ? rng_t(0, 0) :
                 stgr[n][1] ? parent_t::rng_vctr(mem->grid_size[1]) :
                   parent_t::rng_sclr(mem->grid_size[1])
-            )));
+            ), phase));
           }
         }
 
         // helper method to allocate a temporary space composed of vector-component arrays
         static void alloc_tmp_vctr(
           typename parent_t::mem_t *mem,
-          const char * __file__
+          const char * __file__,
+          const int phase = tmp_phase::all
         )
         {
-          alloc_tmp_stgr(mem, __file__, 2, {{true, false}, {false, true}});
+          alloc_tmp_stgr(mem, __file__, 2, {{true, false}, {false, true}}, false, phase);
         }
 
         // helper method to allocate n_arr scalar temporary arrays
@@ -391,7 +409,8 @@ namespace libmpdataxx
           typename parent_t::mem_t *mem,
           const char * __file__, const int n_arr,
           std::string name = "",
-          bool srfc = false
+          bool srfc = false,
+          const int phase = tmp_phase::all
         )
         {
           mem->tmp[__file__].push_back(new arrvec_t<typename parent_t::arr_t>());
@@ -402,7 +421,7 @@ namespace libmpdataxx
             mem->tmp[__file__].back().push_back(mem->old(new typename parent_t::arr_t(
               parent_t::rng_sclr(mem->grid_size[0]),
               srfc ? rng_t(0, 0) : parent_t::rng_sclr(mem->grid_size[1])
-            )));
+            ), phase));
         }
       };
     } // namespace detail
@@ -8,6 +8,8 @@
 
 #include <libmpdata++/solvers/detail/solver_common.hpp>
 
+#include <algorithm>
+
 namespace libmpdataxx
 {
   namespace solvers
@@ -34,26 +36,167 @@ namespace libmpdataxx
 
         const rng_t i, j, k; // TODO: we have ijk in solver_common - could it be removed?
 
+        // extents of cache tiles used in tiled() (non-positive means no tiling in a given dimension)
+        const std::array<int, 3> tile_size;
+
         // generic field used for various statistics (currently Courant number and divergence)
         typename parent_t::arr_t &stat_field; // TODO:/: should be in solver common but cannot be allocated there ?
 
+        // calls f(i, j, k) for each cache tile of extents ts covering the ir x jr x kr block;
+        // tiles are traversed in memory order (k changing fastest)
+        template <class f_t>
+        static void tiled(const std::array<int, 3> &ts, const rng_t &ir, const rng_t &jr, const rng_t &kr, const f_t &f)
+        {
+          const int
+            ni = ts[0] > 0 ? ts[0] : ir.length(),
+            nj = ts[1] > 0 ? ts[1] : jr.length(),
+            nk = ts[2] > 0 ? ts[2] : kr.length();
+
+          for (int ib = ir.first(); ib <= ir.last(); ib += ni)
+            for (int jb = jr.first(); jb <= jr.last(); jb += nj)
+              for (int kb = kr.first(); kb <= kr.last(); kb += nk)
+                f(
+                  rng_t(ib, std::min(ib + ni - 1, ir.last())),
+                  rng_t(jb, std::min(jb + nj - 1, jr.last())),
+                  rng_t(kb, std::min(kb + nk - 1, kr.last()))
+                );
+        }
+
+        // ditto, using the tile extents from rt_params_t
+        template <class f_t>
+        void tiled(const rng_t &ir, const rng_t &jr, const rng_t &kr, const f_t &f) const
+        {
+          tiled(tile_size, ir, jr, kr, f);
+        }
+
+        // ditto, for f taking the tile as an index (as in the dimension-generic layers, see solver_common::tiled())
+        template <class f_t>
+        void tiled(const idx_t<3> &r, const f_t &f) const
+        {
+          tiled(tile_size, r[0], r[1], r[2], [&](const rng_t &i, const rng_t &j, const rng_t &k)
+          {
+            f(idx_t<3>({i, j, k}));
+          });
+        }
+
+        using parent_t::tile_faces;
+
+        // cell-edge faces to the left of a tile t of range r, the leftmost face included only
+        // in the first tile (the others are covered by preceding tiles given the traversal order above)
+        static rng_t tile_faces(const rng_t &t, const rng_t &r)
+        {
+          return t.first() == r.first() ? rng_t(t.first() - 1, t.last()) : t;
+        }
+
         virtual void xchng_sclr(typename parent_t::arr_t &arr,
                        const idx_t<3> &range_ijk,
                        const int ext = 0,
                        const bool deriv = false
         ) final // for a given array
         {
-          const auto range_ijk_0__ext = this->extend_range(range_ijk[0], ext);
+          this->xchng_tracked(arr, range_ijk, ext, deriv, [&]()
+          {
+            const auto range_ijk_0__ext = this->extend_range(0, range_ijk[0], ext);
+            const auto range_ijk_1__ext = this->extend_range(1, range_ijk[1], ext);
+            const auto range_ijk_2__ext = this->extend_range(2, range_ijk[2], ext);
+            this->mem->barrier();
+            for (auto &bc : this->bcs[0]) bc->fill_halos_sclr(arr, range_ijk_1__ext, range_ijk_2__ext, deriv);
+            this->corner_barrier();
+            for (auto &bc : this->bcs[1]) bc->fill_halos_sclr(arr, range_ijk_2__ext, range_ijk_0__ext, deriv);
+            this->corner_barrier();
+            for (auto &bc : this->bcs[2]) bc->fill_halos_sclr(arr, range_ijk_0__ext, range_ijk_1__ext, deriv);
+            this->mem->barrier();
+          });
+        }
+        // split-phase xchng_sclr(): start_xchng_sclr() launches the transfers of the halos in dimension 0
+        // and fills the halos in dimensions 1 and 2 along the subdomain, finish_xchng_sclr() completes
+        // the transfers and fills the corners; in between the halos in dimension 0 must not be used
+        void start_xchng_sclr(typename parent_t::arr_t &arr,
+                       const idx_t<3> &range_ijk,
+                       const int ext = 0,
+                       const bool deriv = false
+        )
+        {
+          const auto range_ijk_1__ext = this->extend_range(1, range_ijk[1], ext);
+          const auto range_ijk_2__ext = this->extend_range(2, range_ijk[2], ext);
           this->mem->barrier();
-          for (auto &bc : this->bcs[0]) bc->fill_halos_sclr(arr, range_ijk[1]^ext, range_ijk[2]^ext, deriv);
-          for (auto &bc : this->bcs[1]) bc->fill_halos_sclr(arr, range_ijk[2]^ext, range_ijk_0__ext, deriv);
-          for (auto &bc : this->bcs[2]) bc->fill_halos_sclr(arr, range_ijk_0__ext, range_ijk[1]^ext, deriv);
+          for (auto &bc : this->bcs[0]) bc->start_fill_halos_sclr(arr, range_ijk_1__ext, range_ijk_2__ext, deriv);
+          this->corner_barrier();
+          for (auto &bc : this->bcs[1]) bc->fill_halos_sclr(arr, range_ijk_2__ext, range_ijk[0], deriv);
+          this->corner_barrier();
+          for (auto &bc : this->bcs[2]) bc->fill_halos_sclr(arr, range_ijk[0], range_ijk_1__ext, deriv);
+          this->mem->barrier();
+        }
+
+        void finish_xchng_sclr(typename parent_t::arr_t &arr,
+                       const idx_t<3> &range_ijk,
+                       const int ext = 0,
+                       const bool deriv = false
+        )
+        {
+          const auto range_ijk_0__ext = this->extend_range(0, range_ijk[0], ext);
+          const auto range_ijk_1__ext = this->extend_range(1, range_ijk[1], ext);
+          const auto range_ijk_2__ext = this->extend_range(2, range_ijk[2], ext);
+          for (auto &bc : this->bcs[0]) bc->finish_fill_halos_sclr(arr, range_ijk_1__ext, range_ijk_2__ext);
+
+          // the parts of the halos in dimensions 1 and 2 adjacent to the halos in dimension 0
+          const bool
+            ext_l = range_ijk_0__ext.first() < range_ijk[0].first(),
+            ext_r = range_ijk_0__ext.last()  > range_ijk[0].last();
+          this->corner_barrier();
+          if (ext_l) for (auto &bc : this->bcs[1]) bc->fill_halos_sclr(arr, range_ijk_2__ext, rng_t(range_ijk_0__ext.first(), range_ijk[0].first() - 1), deriv);
+          if (ext_r) for (auto &bc : this->bcs[1]) bc->fill_halos_sclr(arr, range_ijk_2__ext, rng_t(range_ijk[0].last() + 1, range_ijk_0__ext.last()), deriv);
+          this->corner_barrier();
+          if (ext_l) for (auto &bc : this->bcs[2]) bc->fill_halos_sclr(arr, rng_t(range_ijk_0__ext.first(), range_ijk[0].first() - 1), range_ijk_1__ext, deriv);
+          if (ext_r) for (auto &bc : this->bcs[2]) bc->fill_halos_sclr(arr, rng_t(range_ijk[0].last() + 1, range_ijk_0__ext.last()), range_ijk_1__ext, deriv);
+          this->mem->barrier();
+          this->halo_filled(arr, range_ijk, ext, deriv);
+        }
+
+        // as above but for several arrays, with a single pair of barriers
+        // (and a single message per neighbour with remote bconds)
+        void xchng_sclr(const std::vector<typename parent_t::arr_t*> &arrs,
+                       const idx_t<3> &range_ijk,
+                       const int ext = 0,
+                       const bool deriv = false
+        )
+        {
+          const auto range_ijk_0__ext = this->extend_range(0, range_ijk[0], ext);
+          const auto range_ijk_1__ext = this->extend_range(1, range_ijk[1], ext);
+          const auto range_ijk_2__ext = this->extend_range(2, range_ijk[2], ext);
+          this->mem->barrier();
+          for (auto &bc : this->bcs[0]) bc->fill_halos_sclrs(arrs, range_ijk_1__ext, range_ijk_2__ext, deriv);
+          this->corner_barrier();
+          for (auto &bc : this->bcs[1]) bc->fill_halos_sclrs(arrs, range_ijk_2__ext, range_ijk_0__ext, deriv);
+          this->corner_barrier();
+          for (auto &bc : this->bcs[2]) bc->fill_halos_sclrs(arrs, range_ijk_0__ext, range_ijk_1__ext, deriv);
           this->mem->barrier();
         }
         void xchng(int e) final
         {
           this->xchng_sclr(this->mem->psi[e][ this->n[e]], this->ijk, this->halo);
         }
+        void xchng_eqns(const std::vector<int> &es) final
+        {
+          std::vector<typename parent_t::arr_t*> arrs;
+          for (const int e : es)
+          {
+            auto &psi = this->mem->psi[e][ this->n[e]];
+            if (this->halo_valid(psi, this->ijk, this->halo, false))
+            {
+#if defined(LIBMPDATAXX_CHECK_XCHNG_TRACKING)
+              xchng(e); // checks and counts the skipped exchange, see xchng_tracked()
+#else
+              ++this->n_xchng_skipped;
+#endif
+              continue;
+            }
+            arrs.push_back(&psi);
+          }
+          if (arrs.empty()) return;
+          this->xchng_sclr(arrs, this->ijk, this->halo);
+          for (auto a : arrs) this->halo_filled(*a, this->ijk, this->halo, false);
+        }
 
         void xchng_vctr_alng(arrvec_t<typename parent_t::arr_t> &arrvec, const bool ad = false, const bool cyclic = false) final
         {
@@ -88,7 +231,9 @@ namespace libmpdataxx
         {
           this->mem->barrier();
           for (auto &bc : this->bcs[2]) bc->fill_halos_sgs_div(arr, range_ijk[0], range_ijk[1]);
+          this->corner_barrier();
           for (auto &bc : this->bcs[1]) bc->fill_halos_sgs_div(arr, range_ijk[2]^h, range_ijk[0]);
+          this->corner_barrier();
           for (auto &bc : this->bcs[0]) bc->fill_halos_sgs_div(arr, range_ijk[1], range_ijk[2]^h);
           this->mem->barrier();
         }
@@ -153,12 +298,19 @@ namespace libmpdataxx
           const bool cyclic = false
         ) final
         {
+          // the halos in the second dimension are exchanged together with those filled in the first one
+          // (also by remote bconds, which complete each exchange before returning), hence the corners
+          // get filled also where the subdomains of different processes meet
           this->mem->barrier();
-          const auto range_ijk_0__ext_h = this->extend_range(range_ijk[0], ext, h);
-          const auto range_ijk_0__ext_1 = this->extend_range(range_ijk[0], ext, 1);
+          const auto range_ijk_0__ext_h = this->extend_range(0, range_ijk[0], ext, h);
+          const auto range_ijk_0__ext_1 = this->extend_range(0, range_ijk[0], ext, 1);
+          const auto range_ijk_1__ext_h = this->extend_range(1, range_ijk[1], ext, h);
+          const auto range_ijk_1__ext_1 = this->extend_range(1, range_ijk[1], ext, 1);
+          const auto range_ijk_2__ext_h = this->extend_range(2, range_ijk[2], ext, h);
+          const auto range_ijk_2__ext_1 = this->extend_range(2, range_ijk[2], ext, 1);
           if (!cyclic)
           {
-            for (auto &bc : this->bcs[1]) bc->fill_halos_vctr_nrml(arrvec[0], range_ijk[2]^ext^1, range_ijk[0]^ext^h);
+            for (auto &bc : this->bcs[1]) bc->fill_halos_vctr_nrml(arrvec[0], range_ijk_2__ext_1, range_ijk_0__ext_h);
 
             // without this barrier, there is a race condition when some threads handle subdomains
             // with one gridpoint width, the problem manifests itself, for example, in pbl test
@@ -168,25 +320,32 @@ namespace libmpdataxx
             {
               this->mem->barrier();
             }
+            else
+              this->corner_barrier();
 
-            for (auto &bc : this->bcs[2]) bc->fill_halos_vctr_nrml(arrvec[0], range_ijk_0__ext_h, range_ijk[1]^ext^1);
+            for (auto &bc : this->bcs[2]) bc->fill_halos_vctr_nrml(arrvec[0], range_ijk_0__ext_h, range_ijk_1__ext_1);
 
-            for (auto &bc : this->bcs[0]) bc->fill_halos_vctr_nrml(arrvec[1], range_ijk[1]^ext^h, range_ijk[2]^ext^1);
-            for (auto &bc : this->bcs[2]) bc->fill_halos_vctr_nrml(arrvec[1], range_ijk_0__ext_1, range_ijk[1]^ext^h);
+            for (auto &bc : this->bcs[0]) bc->fill_halos_vctr_nrml(arrvec[1], range_ijk_1__ext_h, range_ijk_2__ext_1);
+            this->corner_barrier();
+            for (auto &bc : this->bcs[2]) bc->fill_halos_vctr_nrml(arrvec[1], range_ijk_0__ext_1, range_ijk_1__ext_h);
 
-            for (auto &bc : this->bcs[0]) bc->fill_halos_vctr_nrml(arrvec[2], range_ijk[1]^ext^1, range_ijk[2]^ext^h);
-            for (auto &bc : this->bcs[1]) bc->fill_halos_vctr_nrml(arrvec[2], range_ijk[2]^ext^h, range_ijk_0__ext_1);
+            for (auto &bc : this->bcs[0]) bc->fill_halos_vctr_nrml(arrvec[2], range_ijk_1__ext_1, range_ijk_2__ext_h);
+            this->corner_barrier();
+            for (auto &bc : this->bcs[1]) bc->fill_halos_vctr_nrml(arrvec[2], range_ijk_2__ext_h, range_ijk_0__ext_1);
           }
           else
           {
-            for (auto &bc : this->bcs[1]) bc->fill_halos_vctr_nrml_cyclic(arrvec[0], range_ijk[2]^ext^1, range_ijk_0__ext_h);
-            for (auto &bc : this->bcs[2]) bc->fill_halos_vctr_nrml_cyclic(arrvec[0], range_ijk_0__ext_h, range_ijk[1]^ext^1);
+            for (auto &bc : this->bcs[1]) bc->fill_halos_vctr_nrml_cyclic(arrvec[0], range_ijk_2__ext_1, range_ijk_0__ext_h);
+            this->corner_barrier();
+            for (auto &bc : this->bcs[2]) bc->fill_halos_vctr_nrml_cyclic(arrvec[0], range_ijk_0__ext_h, range_ijk_1__ext_1);
 
-            for (auto &bc : this->bcs[0]) bc->fill_halos_vctr_nrml_cyclic(arrvec[1], range_ijk[1]^ext^h, range_ijk[2]^ext^1);
-            for (auto &bc : this->bcs[2]) bc->fill_halos_vctr_nrml_cyclic(arrvec[1], range_ijk_0__ext_1, range_ijk[1]^ext^h);
+            for (auto &bc : this->bcs[0]) bc->fill_halos_vctr_nrml_cyclic(arrvec[1], range_ijk_1__ext_h, range_ijk_2__ext_1);
+            this->corner_barrier();
+            for (auto &bc : this->bcs[2]) bc->fill_halos_vctr_nrml_cyclic(arrvec[1], range_ijk_0__ext_1, range_ijk_1__ext_h);
 
-            for (auto &bc : this->bcs[0]) bc->fill_halos_vctr_nrml_cyclic(arrvec[2], range_ijk[1]^ext^1, range_ijk[2]^ext^h);
-            for (auto &bc : this->bcs[1]) bc->fill_halos_vctr_nrml_cyclic(arrvec[2], range_ijk[2]^ext^h, range_ijk_0__ext_1);
+            for (auto &bc : this->bcs[0]) bc->fill_halos_vctr_nrml_cyclic(arrvec[2], range_ijk_1__ext_1, range_ijk_2__ext_h);
+            this->corner_barrier();
+            for (auto &bc : this->bcs[1]) bc->fill_halos_vctr_nrml_cyclic(arrvec[2], range_ijk_2__ext_h, range_ijk_0__ext_1);
           }
           this->mem->barrier();
         }
@@ -197,11 +356,16 @@ namespace libmpdataxx
           const int ext = 0
         ) final
         {
-          const auto range_ijk_0__ext = this->extend_range(range_ijk[0], ext);
+          const auto range_ijk_0__ext = this->extend_range(0, range_ijk[0], ext);
+          const auto range_ijk_1__ext = this->extend_range(1, range_ijk[1], ext);
+          const auto range_ijk_2__ext = this->extend_range(2, range_ijk[2], ext);
           this->mem->barrier();
-          for (auto &bc : this->bcs[0]) bc->fill_halos_pres(arr, range_ijk[1]^ext, range_ijk[2]^ext);
-          for (auto &bc : this->bcs[1]) bc->fill_halos_pres(arr, range_ijk[2]^ext, range_ijk_0__ext);
-          for (auto &bc : this->bcs[2]) bc->fill_halos_pres(arr, range_ijk_0__ext, range_ijk[1]^ext);
+          for (auto &bc : this->bcs[0]) bc->fill_halos_pres(arr, range_ijk_1__ext, range_ijk_2__ext);
+          this->corner_barrier();
+          for (auto &bc : this->bcs[1]) bc->fill_halos_pres(arr, range_ijk_2__ext, range_ijk_0__ext);
+          this->corner_barrier();
+          for (auto &bc : this->bcs[2]) bc->fill_halos_pres(arr, range_ijk_0__ext, range_ijk_1__ext);
+          this->invalidate_halo(arr); // not the halo of xchng_sclr()
           this->mem->barrier();
         }
 
@@ -214,6 +378,7 @@ namespace libmpdataxx
           for (auto &bc : this->bcs[0]) bc->set_edge_pres(av[0], range_ijk[1], range_ijk[2], sign);
           for (auto &bc : this->bcs[1]) bc->set_edge_pres(av[1], range_ijk[2], range_ijk[0], sign);
           for (auto &bc : this->bcs[2]) bc->set_edge_pres(av[2], range_ijk[0], range_ijk[1], sign);
+          for (int d = 0; d < 3; ++d) this->invalidate_halo(av[d]);
           this->mem->barrier();
         }
 
@@ -235,12 +400,15 @@ namespace libmpdataxx
           this->mem->barrier();
           for (auto &bc : this->bcs[0]) bc->copy_edge_sclr_to_halo1_cyclic(arr, range_ijk[1], range_ijk[2]);
           for (auto &bc : this->bcs[0]) bc->avg_edge_and_halo1_sclr_cyclic(arr, range_ijk[1], range_ijk[2]);
+          this->corner_barrier();
 
           for (auto &bc : this->bcs[1]) bc->copy_edge_sclr_to_halo1_cyclic(arr, range_ijk[2], range_ijk[0]);
           for (auto &bc : this->bcs[1]) bc->avg_edge_and_halo1_sclr_cyclic(arr, range_ijk[2], range_ijk[0]);
+          this->corner_barrier();
 
           for (auto &bc : this->bcs[2]) bc->copy_edge_sclr_to_halo1_cyclic(arr, range_ijk[0], range_ijk[1]);
           for (auto &bc : this->bcs[2]) bc->avg_edge_and_halo1_sclr_cyclic(arr, range_ijk[0], range_ijk[1]);
+          this->invalidate_halo(arr);
           this->mem->barrier();
         }
 
@@ -261,22 +429,27 @@ namespace libmpdataxx
 
         real_t courant_number(const arrvec_t<typename parent_t::arr_t> &arrvec) final
         {
-          stat_field(this->ijk) = real_t(0.5) * (
-                                            abs(arrvec[0](i+h, j, k) + arrvec[0](i-h, j, k))
-                                          + abs(arrvec[1](i, j+h, k) + arrvec[1](i, j-h, k))
-                                          + abs(arrvec[2](i, j, k+h) + arrvec[2](i, j, k-h))
-                                         ) / formulae::G<ct_params_t::opts, 0>(*this->mem->G, i, j, k);
+          tiled(this->i, this->j, this->k, [&](const rng_t &i, const rng_t &j, const rng_t &k)
+          {
+            stat_field(i, j, k) = real_t(0.5) * (
+                                              abs(arrvec[0](i+h, j, k) + arrvec[0](i-h, j, k))
+                                            + abs(arrvec[1](i, j+h, k) + arrvec[1](i, j-h, k))
+                                            + abs(arrvec[2](i, j, k+h) + arrvec[2](i, j, k-h))
+                                           ) / formulae::G<ct_params_t::opts, 0>(*this->mem->G, i, j, k);
+          });
           return this->mem->max(this->rank, stat_field(this->ijk));
         }
 
         real_t max_abs_vctr_div(const arrvec_t<typename parent_t::arr_t> &arrvec) final
         {
-          stat_field(this->ijk) =  abs(
-                                         (arrvec[0](i+h, j, k) - arrvec[0](i-h, j, k))
-                                       + (arrvec[1](i, j+h, k) - arrvec[1](i, j-h, k))
-                                       + (arrvec[2](i, j, k+h) - arrvec[2](i, j, k-h))
-                                      ) / formulae::G<ct_params_t::opts, 0>(*this->mem->G, i, j, k);
-
+          tiled(this->i, this->j, this->k, [&](const rng_t &i, const rng_t &j, const rng_t &k)
+          {
+            stat_field(i, j, k) =  abs(
+                                           (arrvec[0](i+h, j, k) - arrvec[0](i-h, j, k))
+                                         + (arrvec[1](i, j+h, k) - arrvec[1](i, j-h, k))
+                                         + (arrvec[2](i, j, k+h) - arrvec[2](i, j, k-h))
+                                        ) / formulae::G<ct_params_t::opts, 0>(*this->mem->G, i, j, k);
+          });
           return this->mem->max(this->rank, stat_field(this->ijk));
         }
 
@@ -310,6 +483,7 @@ namespace libmpdataxx
         struct rt_params_t : parent_t::rt_params_t
         {
           real_t di = 0, dj = 0, dk = 0;
+          std::array<int, 3> tile_size = {{0, 0, 0}}; // cache tiling, see tiled()
         };
 
         protected:
@@ -328,6 +502,7 @@ namespace libmpdataxx
           i(args.i),
           j(args.j),
           k(args.k),
+          tile_size(p.tile_size),
           stat_field(args.mem->tmp[__FILE__][0][0])
         {
           this->di = p.di;
@@ -356,6 +531,9 @@ namespace libmpdataxx
                 parent_t::rng_sclr(mem->grid_size[2])
               )));
 
+          // storage shared between phases sized to fit both scalars and vector components
+          mem->tmp_slot_size = mem->psi[0][0].numElements();
+
           // Courant field components (Arakawa-C grid)
           mem->GC.push_back(mem->old(new typename parent_t::arr_t(
             parent_t::rng_vctr(mem->grid_size[0]),
@@ -438,7 +616,8 @@ namespace libmpdataxx
           const char * __file__,
           const int n_arr,
           const std::vector<std::vector<bool>> &stgr,
-          bool srfc = false // allocate only surface data
+          bool srfc = false, // allocate only surface data
+          const int phase = tmp_phase::all
         )
         {
           mem->tmp[__file__].push_back(new arrvec_t<typename parent_t::arr_t>());
@@ -450,17 +629,18 @@ namespace libmpdataxx
               srfc ? rng_t(0, 0) :
                 stgr[n][2] ? parent_t::rng_vctr(mem->grid_size[2]) :
                   parent_t::rng_sclr(mem->grid_size[2])
-            )));
+            ), phase));
           }
         }
 
         // helper method to allocate a temporary space composed of vector-component arrays
         static void alloc_tmp_vctr(
           typename parent_t::mem_t *mem,
-          const char * __file__
+          const char * __file__,
+          const int phase = tmp_phase::all
         )
         {
-          alloc_tmp_stgr(mem, __file__, 3, {{true, false, false}, {false, true, false}, {false, false, true}});
+          alloc_tmp_stgr(mem, __file__, 3, {{true, false, false}, {false, true, false}, {false, false, true}}, false, phase);
         }
 
         // helper method to allocate n_arr scalar temporary arrays
@@ -468,7 +648,8 @@ namespace libmpdataxx
           typename parent_t::mem_t *mem,
           const char * __file__, const int n_arr,
           std::string name = "",
-          bool srfc = false // allocate only surface data
+          bool srfc = false, // allocate only surface data
+          const int phase = tmp_phase::all
         )
         {
           mem->tmp[__file__].push_back(new arrvec_t<typename parent_t::arr_t>());
@@ -480,7 +661,7 @@ namespace libmpdataxx
               parent_t::rng_sclr(mem->grid_size[0]),
               parent_t::rng_sclr(mem->grid_size[1]),
               srfc ? rng_t(0, 0) : parent_t::rng_sclr(mem->grid_size[2])
-            )));
+            ), phase));
         }
       };
     } // namespace detail
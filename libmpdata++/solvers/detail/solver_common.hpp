@@ -9,12 +9,14 @@
 #include <libmpdata++/blitz.hpp>
 #include <libmpdata++/formulae/arakawa_c.hpp>
 #include <libmpdata++/concurr/detail/sharedmem.hpp>
+#include <libmpdata++/concurr/detail/checkpoint.hpp>
 
 #include <libmpdata++/solvers/detail/monitor.hpp>
 
 #include <libmpdata++/bcond/detail/bcond_common.hpp>
 
 #include <array>
+#include <stdexcept>
 
 namespace libmpdataxx
 {
@@ -29,6 +31,18 @@ namespace libmpdataxx
         return a > b ? a : b;
       }
 
+      // parts of a timestep in which a temporary array holds live data, to be
+      // passed to alloc_tmp_*(); arrays with disjoint phases may share storage
+      namespace tmp_phase
+      {
+        enum : int
+        {
+          advop    = 1 << 0, // within advop() only
+          pressure = 1 << 1, // within the pressure solver loop only
+          all      = -1      // persistent (default)
+        };
+      }
+
       template <typename ct_params_t, int n_tlev_, int minhalo>
       class solver_common
       {
@@ -71,6 +85,10 @@ namespace libmpdataxx
         long long int timestep = 0;
         real_t time = 0;
         std::vector<int> n;
+        const std::array<std::vector<int>, 2> xchng_grps; // see xchng_group()
+
+        // true if the state was loaded from a checkpoint and the solver was not advanced since
+        bool restarted = false;
 
         typedef concurr::detail::sharedmem<real_t, n_dims, n_tlev> mem_t;
         mem_t *mem;
@@ -92,10 +110,112 @@ namespace libmpdataxx
         {
           n[e] = (n[e] + 1) % n_tlev - n_tlev;  // -n_tlev so that n+1 does not give out of bounds
           if(is_last_eqn(e)) mem->cycle(rank);
+          invalidate_halo(e);
         }
 
         virtual void xchng(int e) = 0;
-        // TODO: implement flagging of valid/invalid halo for optimisations
+
+        // halos of several equations filled at once (one after another unless overridden, see solver_3d)
+        virtual void xchng_eqns(const std::vector<int> &es)
+        {
+          for (const int e : es) xchng(e);
+        }
+
+        // halo validity tracking for the advectees (opt-in with ct_params_t::xchng_tracking): a halo
+        // filled by xchng_sclr() is flagged as valid until the advectee is modified, and subsequent
+        // exchanges with the same range and the same or smaller extent are skipped; with tracking
+        // enabled any code modifying an advectee, including the hooks (but not the hook_mixed_rhs_*()
+        // ones, see mpdata_rhs), has to call invalidate_halo() - and on all threads, as otherwise
+        // the threads skip different exchanges (and hence barriers); the flags are reset only at the
+        // beginning of solve() and after hook_ante_loop(), hook_restart() and calc_gc(); with
+        // LIBMPDATAXX_CHECK_XCHNG_TRACKING defined the skipped exchanges are done anyway (with
+        // their barriers) and checked not to change anything
+        struct halo_flag_t
+        {
+          bool valid = false;
+          blitz::TinyVector<int, n_dims> lbound, ubound;
+          int ext;
+          bool deriv;
+        };
+        std::array<halo_flag_t, n_eqns> halo_flags;
+        long long int n_xchng_skipped = 0; // by this thread
+
+        void invalidate_halo(const int e)
+        {
+          halo_flags[e].valid = false;
+        }
+
+        void invalidate_halo(const arr_t &arr)
+        {
+          const int e = advectee_ix(arr);
+          if (e >= 0) invalidate_halo(e);
+        }
+
+        void invalidate_halos()
+        {
+          for (auto &f : halo_flags) f.valid = false;
+        }
+
+        // index of the advectee (at the current time level) held in arr, -1 if none
+        int advectee_ix(const arr_t &arr) const
+        {
+          for (int e = 0; e < n_eqns; ++e)
+            if (arr.data() == mem->psi[e][n[e]].data()) return e;
+          return -1;
+        }
+
+        bool halo_valid(const arr_t &arr, const idx_t<n_dims> &range, const int ext, const bool deriv) const
+        {
+          if (!ct_params_t::xchng_tracking) return false;
+          const int e = advectee_ix(arr);
+          if (e < 0 || !halo_flags[e].valid) return false;
+          const auto &f = halo_flags[e];
+          if (f.ext < ext || f.deriv != deriv) return false;
+          for (int d = 0; d < n_dims; ++d)
+            if (f.lbound[d] != range.lbound(d) || f.ubound[d] != range.ubound(d)) return false;
+          return true;
+        }
+
+        void halo_filled(const arr_t &arr, const idx_t<n_dims> &range, const int ext, const bool deriv)
+        {
+          const int e = advectee_ix(arr);
+          if (e < 0) return;
+          auto &f = halo_flags[e];
+          f.valid = true;
+          f.lbound = range.lbound();
+          f.ubound = range.ubound();
+          f.ext = ext;
+          f.deriv = deriv;
+        }
+
+        // calls xchng_fn filling the halo of arr unless it is flagged as valid
+        template <class f_t>
+        void xchng_tracked(arr_t &arr, const idx_t<n_dims> &range, const int ext, const bool deriv, const f_t &xchng_fn)
+        {
+          if (halo_valid(arr, range, ext, deriv))
+          {
+            ++n_xchng_skipped;
+#if defined(LIBMPDATAXX_CHECK_XCHNG_TRACKING)
+            // the part of the array filled by this thread (interior and halos)
+            blitz::TinyVector<int, n_dims> lbound, ubound;
+            for (int d = 0; d < n_dims; ++d)
+            {
+              const auto r = extend_range(d, rng_t(range.lbound(d), range.ubound(d)), ext);
+              lbound[d] = r.first();
+              ubound[d] = r.last();
+            }
+            const idx_t<n_dims> own(lbound, ubound);
+            const arr_t before = arr(own).copy();
+            xchng_fn();
+            // not an assert() so that the check works in release builds as well
+            if (!all(arr(own) == before || (arr(own) != arr(own) && before != before)))
+              throw std::logic_error("halo flagged as valid changed by xchng (an advectee modified without invalidate_halo()?)");
+#endif
+            return;
+          }
+          xchng_fn();
+          halo_filled(arr, range, ext, deriv);
+        }
 
         virtual void xchng_vctr_alng(arrvec_t<arr_t>&, const bool ad = false, const bool cyclic = false) = 0;
 
@@ -103,8 +223,8 @@ namespace libmpdataxx
         {
           // with distributed memory and cyclic boundary conditions,
           // leftmost node must send left first, as
-          // rightmost node is waiting
-          if (d == 0 && this->mem->distmem.size() > 0 && this->mem->distmem.rank() == 0)
+          // rightmost node is waiting (in each dimension split between processes)
+          if ((d == 0 || this->mem->distmem.dims[d] > 1) && this->mem->distmem.coords[d] == 0)
             std::swap(bcl, bcr);
 
           bcs[d][0] = std::move(bcl);
@@ -122,10 +242,25 @@ namespace libmpdataxx
 
         virtual void scale_gc(const real_t time, const real_t cur_dt, const real_t prev_dt) = 0;
 
+        // true if the halos of advectees are filled within advop() (see mpdata_osc_3d)
+        static constexpr bool xchng_in_advop = ct_params_t::overlap_xchng && n_dims == 3;
+
+        // equations (delayed or not) which halos are filled together before advecting any of them,
+        // i.e. all but the ones rescaled before advection (see hint_scale)
+        static std::vector<int> xchng_group(const bool delayed)
+        {
+          std::vector<int> es;
+          if (xchng_in_advop) return es;
+          for (int e = 0; e < n_eqns; ++e)
+            if (opts::isset(ct_params_t::delayed_step, opts::bit(e)) == delayed && ct_params_t::hint_scale(e) == 0)
+              es.push_back(e);
+          return es;
+        }
+
         void solve_loop_body(const int e)
         {
           scale(e, ct_params_t::hint_scale(e));
-          xchng(e);
+          if (ct_params_t::hint_scale(e) != 0 && !xchng_in_advop) xchng(e); // otherwise done in xchng_group
           advop(e);
           if(!is_last_eqn(e))
             mem->barrier();
@@ -133,21 +268,55 @@ namespace libmpdataxx
           scale(e, -ct_params_t::hint_scale(e));
         }
 
-        // thread-aware range extension
+        // thread-aware range extension (r is extended only at the edges
+        // of the domain, i.e. where there is no neighbouring thread subdomain in dimension d)
         template <class n_t>
-        rng_t extend_range(const rng_t &r, const n_t n) const
+        rng_t extend_range(const int &d, const rng_t &r, const n_t n) const
         {
-          if (mem->size == 1) return r^n;
-          return rank == 0 ? rng_t((r - n).first(), r.last()) :
-                               rank == mem->size - 1 ? rng_t(r.first(), (r + n).last()) :
-                                 r;
+          const int crd = mem->thrd_crd(rank, d), nsd = mem->decomp[d];
+          if (nsd == 1) return r^n;
+          return crd == 0 ? rng_t((r - n).first(), r.last()) :
+                              crd == nsd - 1 ? rng_t(r.first(), (r + n).last()) :
+                                r;
         }
 
         // thread-aware range extension, variadic version
         template <class n_t, class... ns_t>
-        rng_t extend_range(const rng_t &r, const n_t n, const ns_t... ns) const
+        rng_t extend_range(const int &d, const rng_t &r, const n_t n, const ns_t... ns) const
         {
-          return extend_range(extend_range(r, n), ns...);
+          return extend_range(d, extend_range(d, r, n), ns...);
+        }
+
+        // with subdomains split in more than one dimension, halo corners filled
+        // by one thread are read by another when filling halos in the next dimension
+        void corner_barrier()
+        {
+          for (int d = 1; d < n_dims; ++d)
+          {
+            if (mem->decomp[d] > 1)
+            {
+              mem->barrier();
+              return;
+            }
+          }
+        }
+
+        // calls f(t) for each cache tile t of the block r, used by the dimension-generic layers
+        // to evaluate formulae tile by tile; only the 3D solvers split r (see solver_3d::tiled())
+        template <class f_t>
+        void tiled(const idx_t<n_dims> &r, const f_t &f) const
+        {
+          f(r);
+        }
+
+        // a tile t of block r with the ranges of the block rm (r extended to the left by the
+        // cell-edge faces, e.g. ijkm) in the dimensions in which t is the leftmost tile of r
+        static idx_t<n_dims> tile_faces(const idx_t<n_dims> &t, const idx_t<n_dims> &r, const idx_t<n_dims> &rm)
+        {
+          auto tm = t;
+          for (int d = 0; d < n_dims; ++d)
+            if (t.lbound(d) == r.lbound(d)) tm.lbound()(d) = rm.lbound(d);
+          return tm;
         }
 
         private:
@@ -208,16 +377,38 @@ namespace libmpdataxx
           }
         }
 
+        // called in place of hook_ante_loop() when advancing a solver restarted from a checkpoint
+        // (that is with the state already initialised)
+        virtual void hook_restart(const advance_arg_t nt)
+        {}
+
         public:
 
         const real_t time_() const { return time;}
 
+        // saves or loads the scalars of the solver state (the arrays are in mem);
+        // any overriding state_io() must call parent_t::state_io()
+        virtual void state_io(concurr::detail::state_io_t &io)
+        {
+          io(timestep);
+          io(time);
+          io(dt);
+          io(dt_stash);
+          io(n);
+          if (io.load) restarted = true;
+        }
+
         struct rt_params_t
         {
           std::array<int, n_dims> grid_size;
           real_t dt=0, max_abs_div_eps = blitz::epsilon(real_t(44)), max_courant = real_t(0.5);
         };
 
+        // allocation of the arrays depending on run-time parameters other than n_iters,
+        // called by concurr_common after alloc()
+        static void alloc_rt(mem_t *mem, const rt_params_t &p)
+        {}
+
         // ctor
         solver_common(
           const int &rank,
@@ -234,6 +425,7 @@ namespace libmpdataxx
           max_abs_div_eps(p.max_abs_div_eps),
           max_courant(p.max_courant),
           n(n_eqns, 0),
+          xchng_grps{{xchng_group(false), xchng_group(true)}},
           mem(mem),
           ijk(ijk)
         {
@@ -271,6 +463,9 @@ namespace libmpdataxx
           // TODO: does it really work with var_dt ? we do not advance by time exactly ...
           nt += ct_params_t::var_dt ? time : timestep;
 
+          // advectees might have been modified since the last call
+          invalidate_halos();
+
           // being generous about out-of-loop barriers
           if (timestep == 0)
           {
@@ -279,6 +474,16 @@ namespace libmpdataxx
             hook_ante_loop_called = false;
 #endif
             hook_ante_loop(nt);
+            invalidate_halos();
+            restarted = false;
+            mem->barrier();
+          }
+          else if (restarted)
+          {
+            mem->barrier();
+            hook_restart(nt);
+            invalidate_halos();
+            restarted = false;
             mem->barrier();
           }
 
@@ -326,8 +531,10 @@ namespace libmpdataxx
             // for third-order MPDATA we need to calculate time derivatives of the advector field
             if (var_gc && div3_mpdata) calc_ndt_gc();
 
+            invalidate_halos(); // e.g. calc_gc() might have modified advectees
             hook_ante_step();
 
+            xchng_eqns(xchng_grps[0]);
             for (int e = 0; e < n_eqns; ++e)
             {
               if (opts::isset(ct_params_t::delayed_step, opts::bit(e))) continue;
@@ -336,6 +543,7 @@ namespace libmpdataxx
 
             hook_ante_delayed_step();
 
+            xchng_eqns(xchng_grps[1]);
             for (int e = 0; e < n_eqns; ++e)
             {
               if (!opts::isset(ct_params_t::delayed_step, opts::bit(e))) continue;
@@ -372,7 +580,8 @@ namespace libmpdataxx
         void scale(const int &e, const int &exp)
         {
           if (exp == 0) return;
-          else if (exp > 0) state(e)(ijk) /= (1 << exp);
+          invalidate_halo(e);
+          if (exp > 0) state(e)(ijk) /= (1 << exp);
           else if (exp < 0) state(e)(ijk) *= (1 << -exp);
         }
       };
@@ -10,6 +10,8 @@
 
 #include <libmpdata++/solvers/mpdata.hpp>
 
+#include <numeric>
+
 #pragma once
 
 namespace libmpdataxx
@@ -71,7 +73,12 @@ namespace libmpdataxx
         }
 
         // fill halos with data (e.g. for computing gradients)
-        for (int e = 0; e < parent_t::n_eqns; ++e) this->xchng(e);
+        static const std::vector<int> all_eqns = [] {
+          std::vector<int> es(parent_t::n_eqns);
+          std::iota(es.begin(), es.end(), 0);
+          return es;
+        }();
+        this->xchng_eqns(all_eqns);
       }
 
       virtual void apply_rhs(
@@ -85,6 +92,7 @@ namespace libmpdataxx
 
           // otherwise apply the rhs
           this->state(e)(this->ijk) += dt_arg * rhs.at(e)(this->ijk);
+          this->invalidate_halo(e);
         }
       }
 
@@ -166,6 +174,7 @@ namespace libmpdataxx
             break;
           case rhs_scheme_t::mixed:
             hook_mixed_rhs_ante_step();
+            this->invalidate_halos(); // the advectees are modified there by user code
             break;
           default:
             assert(false);
@@ -188,6 +197,7 @@ namespace libmpdataxx
             break;
           case rhs_scheme_t::mixed:
             hook_mixed_rhs_post_step();
+            this->invalidate_halos(); // ditto
             break;
           default:
             assert(false);
@@ -0,0 +1,102 @@
+/*
+ * @file
+ * @copyright University of Warsaw
+ * @section LICENSE
+ * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
+ *
+ * microbenchmark comparing the blocking (mutex + condition variable) barrier,
+ * the lock-free spin barrier and the OpenMP barrier; each thread does a tiny
+ * amount of work between barriers, as with small per-thread subdomains
+ */
+
+#include <libmpdata++/concurr/cxx11_thread.hpp>
+#include <libmpdata++/concurr/detail/spin_barrier.hpp>
+
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+#if defined(_OPENMP)
+#  include <omp.h>
+#endif
+
+using namespace libmpdataxx::concurr;
+
+const int n_iters = 20000;
+
+// returns the mean time per barrier in microseconds
+template <class barrier_t>
+double bench(const int n_threads)
+{
+  barrier_t b(n_threads);
+  std::vector<long> work(n_threads * 16, 0); // padded to keep threads' counters on separate cache lines
+  std::atomic<long> sum(0);
+
+  auto body = [&](const int rank)
+  {
+    for (int it = 0; it < n_iters; ++it)
+    {
+      work[rank * 16] += it;
+      b.wait();
+      // the master thread checks that all others have reached the current iteration
+      if (rank == 0)
+        for (int r = 0; r < n_threads; ++r) sum += work[r * 16];
+      b.wait();
+    }
+  };
+
+  const auto t0 = std::chrono::steady_clock::now();
+  std::vector<std::thread> threads;
+  for (int r = 0; r < n_threads; ++r) threads.emplace_back(body, r);
+  for (auto &th : threads) th.join();
+  const auto t1 = std::chrono::steady_clock::now();
+
+  const long expected = long(n_threads) * n_iters * (long(n_iters) - 1) * (long(n_iters) + 1) / 6;
+  if (sum != expected) throw std::runtime_error("barrier failed to synchronise threads");
+
+  return std::chrono::duration<double, std::micro>(t1 - t0).count() / (2 * n_iters);
+}
+
+#if defined(_OPENMP)
+double bench_omp(const int n_threads)
+{
+  std::vector<long> work(n_threads * 16, 0);
+  long sum = 0;
+
+  const auto t0 = std::chrono::steady_clock::now();
+#pragma omp parallel num_threads(n_threads)
+  {
+    const int rank = omp_get_thread_num();
+    for (int it = 0; it < n_iters; ++it)
+    {
+      work[rank * 16] += it;
+#pragma omp barrier
+      if (rank == 0)
+        for (int r = 0; r < n_threads; ++r) sum += work[r * 16];
+#pragma omp barrier
+    }
+  }
+  const auto t1 = std::chrono::steady_clock::now();
+
+  return std::chrono::duration<double, std::micro>(t1 - t0).count() / (2 * n_iters);
+}
+#endif
+
+int main()
+{
+  const int n_max = std::max(2u, std::thread::hardware_concurrency());
+
+  std::cout << "threads\tblocking [us]\tspin [us]\tomp [us]" << std::endl;
+  for (int n = 2; n <= n_max; n *= 2)
+  {
+    std::cout << n
+      << "\t" << bench<detail::barrier>(n)
+      << "\t" << bench<detail::spin_barrier>(n)
+#if defined(_OPENMP)
+      << "\t" << bench_omp(n)
+#else
+      << "\t" << "n/a"
+#endif
+      << std::endl;
+  }
+}
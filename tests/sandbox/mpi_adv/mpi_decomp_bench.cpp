@@ -0,0 +1,83 @@
+/*
+ * @file
+ * @copyright University of Warsaw
+ * @section LICENSE
+ * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
+ *
+ * benchmark of the MPI domain decomposition (to be run with different numbers of MPI processes
+ * and different numbers of dimensions split between them, e.g. LIBMPDATAXX_MPI_DIMS=2 mpirun -np N mpi_decomp_bench):
+ * 3D advection with cyclic boundary conditions, the wall time per timestep reported together with
+ * the number of halo cells exchanged per process (the surface-to-volume ratio of the subdomains)
+ */
+
+#include <libmpdata++/solvers/mpdata.hpp>
+#include <libmpdata++/concurr/threads.hpp>
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <cstdlib>
+
+using namespace libmpdataxx;
+
+struct ct_params_t : ct_params_default_t
+{
+  using real_t = double;
+  enum { n_dims = 3 };
+  enum { n_eqns = 1 };
+};
+
+const int nt = 20, nx = 128, ny = 128, nz = 64;
+
+int main()
+{
+  typename solvers::mpdata<ct_params_t>::rt_params_t p;
+  p.grid_size = {nx, ny, nz};
+  p.n_iters = 2;
+
+  concurr::threads<
+    solvers::mpdata<ct_params_t>,
+    bcond::cyclic, bcond::cyclic,
+    bcond::cyclic, bcond::cyclic,
+    bcond::cyclic, bcond::cyclic
+  > slv(p);
+
+  blitz::firstIndex i;
+  blitz::secondIndex j;
+  blitz::thirdIndex k;
+  slv.advectee() = exp(-(pow2(i - nx / 2.) + pow2(j - ny / 2.) + pow2(k - nz / 2.)) / 100);
+  slv.advector(0) = .5;
+  slv.advector(1) = .25;
+  slv.advector(2) = .125;
+
+  const auto sub = slv.advectee().shape();
+  const double mass_0 = sum(slv.advectee_global());
+
+  const auto t0 = std::chrono::steady_clock::now();
+  slv.advance(nt);
+  const double t = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+  // the exchanges have to conserve the total mass
+  const double mass = sum(slv.advectee_global());
+  if (std::abs(mass - mass_0) > 1e-10 * mass_0)
+    throw std::runtime_error("mass not conserved");
+
+  int rank = 0, size = 1;
+#if defined(USE_MPI)
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &size);
+#endif
+  if (rank != 0) return 0;
+
+  // halo cells (one layer) of the subdomain of process 0 in the dimensions split between processes
+  long halo = 0;
+  for (int d = 0; d < 3; ++d)
+    if (sub[d] < p.grid_size[d]) halo += 2 * long(sub[0]) * sub[1] * sub[2] / sub[d];
+
+  const char *dims = std::getenv("LIBMPDATAXX_MPI_DIMS");
+  std::cout << "processes: " << size
+            << " decomposed dimensions: " << (dims != NULL ? dims : "default")
+            << " subdomain: " << sub[0] << "x" << sub[1] << "x" << sub[2]
+            << " halo/volume: " << double(halo) / (long(sub[0]) * sub[1] * sub[2])
+            << " time per step: " << t / nt << " s" << std::endl;
+}
@@ -0,0 +1,117 @@
+/*
+ * @file
+ * @copyright University of Warsaw
+ * @section LICENSE
+ * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
+ *
+ * benchmark of the HDF5 output write bandwidth (to be run with different numbers of MPI processes,
+ * e.g. mpirun -np N mpi_io_bench [alignment in bytes]): a 3D field recorded every timestep
+ * together with auxiliary records (a field with halos, a surface field, a scalar and a profile),
+ * the time spent on output estimated as the difference to a run without output
+ */
+
+#include <libmpdata++/solvers/mpdata.hpp>
+#include <libmpdata++/concurr/threads.hpp>
+#include <libmpdata++/output/hdf5.hpp>
+
+#include <chrono>
+#include <iostream>
+#include <cstdlib>
+
+using namespace libmpdataxx;
+
+struct ct_params_t : ct_params_default_t
+{
+  using real_t = double;
+  enum { n_dims = 3 };
+  enum { n_eqns = 1 };
+};
+
+const int nt = 10, nx = 256, ny = 128, nz = 64;
+
+// output with auxiliary records written along with each record
+class slv_out_t : public output::hdf5<solvers::mpdata<ct_params_t>>
+{
+  using parent_t = output::hdf5<solvers::mpdata<ct_params_t>>;
+
+  void record_all()
+  {
+    parent_t::record_all();
+    this->record_aux_dsc("psi_aux", this->mem->advectee());
+    this->record_aux_dsc("psi_srfc", this->mem->advectee(), true);
+    this->record_aux_scalar("step", this->timestep);
+  }
+
+  void hook_ante_loop(const typename parent_t::advance_arg_t nt)
+  {
+    parent_t::hook_ante_loop(nt);
+    if (this->rank == 0)
+    {
+      std::vector<typename ct_params_t::real_t> prof(nz, 1);
+      this->record_prof_const("prof", prof.data());
+    }
+  }
+
+  public:
+
+  slv_out_t(
+    typename parent_t::ctor_args_t args,
+    const typename parent_t::rt_params_t &p
+  ) : parent_t(args, p)
+  {}
+};
+
+// returns the time spent in advance() in seconds
+double run(const int outfreq, const hsize_t alignment)
+{
+  typename slv_out_t::rt_params_t p;
+  p.grid_size = {nx, ny, nz};
+  p.outfreq = outfreq;
+  p.outdir = "out_io_bench";
+  p.outvars[0].name = "psi";
+  p.out_alignment = alignment;
+
+  concurr::threads<
+    slv_out_t,
+    bcond::cyclic, bcond::cyclic,
+    bcond::cyclic, bcond::cyclic,
+    bcond::cyclic, bcond::cyclic
+  > slv(p);
+
+  blitz::firstIndex i;
+  blitz::secondIndex j;
+  blitz::thirdIndex k;
+  slv.advectee() = exp(-(pow2(i - nx / 2.) + pow2(j - ny / 2.) + pow2(k - nz / 2.)) / 100);
+  slv.advector(0) = .5;
+  slv.advector(1) = .25;
+  slv.advector(2) = .125;
+
+  const auto t0 = std::chrono::steady_clock::now();
+  slv.advance(nt);
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+int main(int argc, char **argv)
+{
+  const hsize_t alignment = argc > 1 ? std::atoll(argv[1]) : 0;
+
+  // the first run also warms up the file system
+  run(1, alignment);
+  const double
+    t_out = run(1, alignment),
+    t_no_out = run(nt + 1, alignment); // only the initial record
+
+  int rank = 0, size = 1;
+#if defined(USE_MPI)
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &size);
+#endif
+  if (rank != 0) return 0;
+
+  // psi and psi_aux with nz levels, psi_srfc with one, as floats
+  const double mb = double(nt) * nx * ny * (2 * nz + 1) * sizeof(float) / (1 << 20);
+  std::cout << "processes: " << size
+            << " alignment: " << alignment
+            << " output time: " << t_out - t_no_out << " s"
+            << " bandwidth: " << mb / (t_out - t_no_out) << " MB/s" << std::endl;
+}
@@ -0,0 +1,126 @@
+/*
+ * @file
+ * @copyright University of Warsaw
+ * @section LICENSE
+ * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
+ *
+ * benchmark of the per-variable codec and precision settings of the HDF5 output:
+ * a smooth 3D field advected and recorded every timestep with each of the settings,
+ * reporting bytes written, throughput (uncompressed float32 size per second of the run,
+ * including the solver)
+ * and the maximal error with respect to the float64 output
+ */
+
+#include <libmpdata++/solvers/mpdata.hpp>
+#include <libmpdata++/concurr/cxx11_thread.hpp>
+#include <libmpdata++/output/hdf5.hpp>
+
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+
+using namespace libmpdataxx;
+
+struct ct_params_t : ct_params_default_t
+{
+  using real_t = double;
+  enum { n_dims = 3 };
+  enum { n_eqns = 1 };
+};
+
+using slv_out_t = output::hdf5<solvers::mpdata<ct_params_t>>;
+
+const int nt = 10, nx = 128, ny = 128, nz = 64;
+
+struct setup_t
+{
+  std::string label;
+  output::codec_t codec;
+  output::precision_t precision;
+  bool shuffle;
+  double tolerance;
+};
+
+// returns the time spent in advance() in seconds
+double run(const std::string &outdir, const setup_t &s)
+{
+  typename slv_out_t::rt_params_t p;
+  p.grid_size = {nx, ny, nz};
+  p.outfreq = 1;
+  p.outdir = outdir;
+  p.outvars[0].name = "psi";
+  p.outvars[0].codec = s.codec;
+  p.outvars[0].precision = s.precision;
+  p.outvars[0].shuffle = s.shuffle;
+  p.outvars[0].tolerance = s.tolerance;
+
+  concurr::cxx11_thread<
+    slv_out_t,
+    bcond::cyclic, bcond::cyclic,
+    bcond::cyclic, bcond::cyclic,
+    bcond::cyclic, bcond::cyclic
+  > slv(p);
+
+  blitz::firstIndex i;
+  blitz::secondIndex j;
+  blitz::thirdIndex k;
+  slv.advectee() = 300 + exp(-(pow2(i - nx / 2.) + pow2(j - ny / 2.) + pow2(k - nz / 2.)) / 200);
+  slv.advector(0) = .2;
+  slv.advector(1) = -.1;
+  slv.advector(2) = .1;
+
+  const auto t0 = std::chrono::steady_clock::now();
+  slv.advance(nt);
+  const auto t1 = std::chrono::steady_clock::now();
+  return std::chrono::duration<double>(t1 - t0).count();
+}
+
+std::string timestep_file(const std::string &outdir, const int t)
+{
+  std::ostringstream name;
+  name << outdir << "/timestep" << std::setw(10) << std::setfill('0') << t << ".h5";
+  return name.str();
+}
+
+int main()
+{
+  const std::vector<setup_t> setups = {
+    {"float64 deflate",        output::codec_t::deflate,        output::precision_t::float64, false, 0},
+    {"float32 none",           output::codec_t::none,           output::precision_t::float32, false, 0},
+    {"float32 deflate",        output::codec_t::deflate,        output::precision_t::float32, false, 0},
+    {"float32 shuffle+deflate",output::codec_t::deflate,        output::precision_t::float32, true,  0},
+    {"float32 quantize 1e-4",  output::codec_t::quantize,       output::precision_t::float32, true,  1e-4},
+    {"float32 fixed_acc 1e-4", output::codec_t::fixed_accuracy, output::precision_t::float32, false, 1e-4},
+    {"float16 deflate",        output::codec_t::deflate,        output::precision_t::float16, false, 0},
+    {"float16 quantize 1e-3",  output::codec_t::quantize,       output::precision_t::float16, true,  1e-3},
+  };
+
+  const double raw_bytes = double(nx) * ny * nz * sizeof(float) * (nt + 1);
+  std::vector<std::string> outdirs;
+
+  std::cout << std::left << std::setw(26) << "setup" << std::right
+            << "\t" << "MiB written" << "\t" << "ratio" << "\t" << "MiB/s" << "\t" << "max error" << std::endl;
+  for (const auto &s : setups)
+  {
+    outdirs.push_back(boost::filesystem::unique_path().native());
+    const double time = run(outdirs.back(), s);
+
+    double bytes = 0, err = 0;
+    blitz::Array<double, 3> ref(nx, ny, nz), val(nx, ny, nz);
+    for (int t = 0; t <= nt; ++t)
+    {
+      bytes += boost::filesystem::file_size(timestep_file(outdirs.back(), t));
+      H5::H5File(timestep_file(outdirs.front(), t), H5F_ACC_RDONLY).openDataSet("psi").read(ref.data(), H5::PredType::NATIVE_DOUBLE);
+      H5::H5File(timestep_file(outdirs.back(), t), H5F_ACC_RDONLY).openDataSet("psi").read(val.data(), H5::PredType::NATIVE_DOUBLE);
+      err = std::max(err, double(max(abs(val - ref))));
+    }
+
+    std::cout << std::left << std::setw(26) << s.label << std::right
+              << "\t" << bytes / (1 << 20)
+              << "\t" << raw_bytes / bytes
+              << "\t" << raw_bytes / (1 << 20) / time
+              << "\t" << err << std::endl;
+  }
+
+  for (const auto &d : outdirs) boost::filesystem::remove_all(d);
+}
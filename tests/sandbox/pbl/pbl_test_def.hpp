@@ -74,6 +74,7 @@ void test(const std::string &dirname, const int np, const int nt)
   p.g = 10;
   p.hflux_const = 0.01;
   p.hscale = 25;
+  p.tile_size = {{8, 8, 16}}; // cache tiling of the stencils, results as without it (see solver_3d::tiled())
   
   set_sgs_specific(p, sgs_t{});
 
@@ -0,0 +1,141 @@
+/**
+ * @file
+ * @copyright University of Warsaw
+ * @section LICENSE
+ * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
+ *
+ * checks if the auxiliary records written from a hook and from within record_all()
+ * with the output written asynchronously by a background thread land in the same files
+ * (and xdmf markup) as the ones written synchronously
+ */
+
+#include <libmpdata++/solvers/mpdata.hpp>
+#include <libmpdata++/concurr/cxx11_thread.hpp>
+#include <libmpdata++/output/hdf5_xdmf.hpp>
+
+#include <fstream>
+
+using namespace libmpdataxx;
+
+struct ct_params_t : ct_params_default_t
+{
+  using real_t = double;
+  enum { n_dims = 2 };
+  enum { n_eqns = 1 };
+};
+
+const int nt = 20, outfreq = 2;
+
+class slv_out_t : public output::hdf5_xdmf<solvers::mpdata<ct_params_t>>
+{
+  using parent_t = output::hdf5_xdmf<solvers::mpdata<ct_params_t>>;
+
+  // recorded from a hook while the writer thread may still be writing the preceding record
+  // (as e.g. in the pbl sandbox)
+  void hook_ante_step()
+  {
+    parent_t::hook_ante_step();
+
+    if (this->timestep % outfreq == 0)
+    {
+      this->mem->barrier();
+      if (this->rank == 0) this->record_aux_dsc("aux", this->mem->advectee());
+      this->mem->barrier();
+    }
+  }
+
+  // recorded along with each record (from the writer thread with out_async)
+  void record_all()
+  {
+    parent_t::record_all();
+    this->record_aux_scalar("step", this->record_timestep);
+  }
+
+  public:
+
+  // ctor
+  slv_out_t(
+    typename parent_t::ctor_args_t args,
+    const typename parent_t::rt_params_t &p
+  ) : parent_t(args, p)
+  {}
+};
+
+void run(const std::string &outdir, const bool async)
+{
+  typename slv_out_t::rt_params_t p;
+  p.grid_size = {32, 24};
+  p.outfreq = outfreq;
+  p.outdir = outdir;
+  p.out_async = async;
+
+  concurr::cxx11_thread<
+    slv_out_t,
+    bcond::cyclic, bcond::cyclic,
+    bcond::cyclic, bcond::cyclic
+  > slv(p);
+
+  blitz::firstIndex i;
+  blitz::secondIndex j;
+  slv.advectee() = exp(-(pow2(i - 11.) + pow2(j - 9.)) / 10);
+  slv.advector(0) = .2;
+  slv.advector(1) = -.3;
+  slv.advance(nt);
+}
+
+std::string base_name(const std::string &outdir, const int t)
+{
+  std::ostringstream name;
+  name << outdir << "/timestep" << std::setw(10) << std::setfill('0') << t;
+  return name.str();
+}
+
+blitz::Array<float, 2> read(const std::string &outdir, const int t, const std::string &var)
+{
+  H5::H5File h5(base_name(outdir, t) + ".h5", H5F_ACC_RDONLY);
+  auto dset = h5.openDataSet(var);
+  hsize_t dims[2];
+  dset.getSpace().getSimpleExtentDims(dims, NULL);
+  blitz::Array<float, 2> arr(dims[0], dims[1]);
+  dset.read(arr.data(), H5::PredType::NATIVE_FLOAT);
+  return arr;
+}
+
+float read_step(const std::string &outdir, const int t)
+{
+  H5::H5File h5(base_name(outdir, t) + ".h5", H5F_ACC_RDONLY);
+  float step;
+  h5.openGroup("/").openAttribute("step").read(H5::PredType::NATIVE_FLOAT, &step);
+  return step;
+}
+
+std::string slurp(const std::string &name)
+{
+  std::ifstream f(name);
+  if (!f) throw std::runtime_error("cannot open " + name);
+  return std::string(std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>());
+}
+
+int main()
+{
+  const std::string sync_dir = boost::filesystem::unique_path().native();
+  const std::string async_dir = boost::filesystem::unique_path().native();
+
+  run(sync_dir, false);
+  run(async_dir, true);
+
+  for (int t = 0; t <= nt; t += outfreq)
+  {
+    if (read_step(async_dir, t) != t)
+      throw std::runtime_error("auxiliary scalar recorded in a wrong file");
+
+    if (t < nt && any(read(sync_dir, t, "aux") != read(async_dir, t, "aux")))
+      throw std::runtime_error("auxiliary record written asynchronously differs from the synchronous one");
+
+    if (slurp(base_name(sync_dir, t) + ".xmf") != slurp(base_name(async_dir, t) + ".xmf"))
+      throw std::runtime_error("xdmf markup written asynchronously differs from the synchronous one");
+  }
+
+  if (slurp(sync_dir + "/temp.xmf") != slurp(async_dir + "/temp.xmf"))
+    throw std::runtime_error("temporal xdmf markup written asynchronously differs from the synchronous one");
+}
@@ -0,0 +1,79 @@
+/**
+ * @file
+ * @copyright University of Warsaw
+ * @section LICENSE
+ * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
+ *
+ * checks if the output written asynchronously by a background thread
+ * is the same as the one written synchronously
+ */
+
+#include <libmpdata++/solvers/mpdata.hpp>
+#include <libmpdata++/concurr/cxx11_thread.hpp>
+#include <libmpdata++/output/hdf5_xdmf.hpp>
+
+using namespace libmpdataxx;
+
+struct ct_params_t : ct_params_default_t
+{
+  using real_t = double;
+  enum { n_dims = 2 };
+  enum { n_eqns = 1 };
+};
+
+const int nt = 20, outfreq = 2;
+
+void run(const std::string &outdir, const bool async)
+{
+  using slv_out_t = output::hdf5_xdmf<solvers::mpdata<ct_params_t>>;
+  typename slv_out_t::rt_params_t p;
+  p.grid_size = {32, 24};
+  p.outfreq = outfreq;
+  p.outdir = outdir;
+  p.out_async = async;
+
+  concurr::cxx11_thread<
+    slv_out_t,
+    bcond::cyclic, bcond::cyclic,
+    bcond::cyclic, bcond::cyclic
+  > slv(p);
+
+  blitz::firstIndex i;
+  blitz::secondIndex j;
+  slv.advectee() = exp(-(pow2(i - 11.) + pow2(j - 9.)) / 10);
+  slv.advector(0) = .2;
+  slv.advector(1) = -.3;
+  slv.advance(nt / 2);
+  slv.advance(nt / 2);
+}
+
+blitz::Array<float, 2> read(const std::string &outdir, const int t)
+{
+  std::ostringstream name;
+  name << outdir << "/timestep" << std::setw(10) << std::setfill('0') << t << ".h5";
+  H5::H5File h5(name.str(), H5F_ACC_RDONLY);
+  auto dset = h5.openDataSet("psi");
+  hsize_t dims[2];
+  dset.getSpace().getSimpleExtentDims(dims, NULL);
+  blitz::Array<float, 2> arr(dims[0], dims[1]);
+  dset.read(arr.data(), H5::PredType::NATIVE_FLOAT);
+  return arr;
+}
+
+int main()
+{
+  const std::string sync_dir = boost::filesystem::unique_path().native();
+  const std::string async_dir = boost::filesystem::unique_path().native();
+
+  run(sync_dir, false);
+  run(async_dir, true);
+
+  for (int t = 0; t <= nt; t += outfreq)
+  {
+    if (any(read(sync_dir, t) != read(async_dir, t)))
+      throw std::runtime_error("asynchronous output differs from the synchronous one");
+  }
+
+  if (!boost::filesystem::exists(async_dir + "/temp.xmf"))
+    throw std::runtime_error("xdmf markup not written");
+}
@@ -0,0 +1,116 @@
+/**
+ * @file
+ * @copyright University of Warsaw
+ * @section LICENSE
+ * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
+ *
+ * checks if a run stopped, checkpointed and restarted in another solver instance
+ * gives bitwise-identical results to an uninterrupted run
+ */
+
+#include <libmpdata++/solvers/mpdata_rhs_vip_prs.hpp>
+#include <libmpdata++/concurr/cxx11_thread.hpp>
+
+#include <boost/filesystem.hpp>
+
+using namespace libmpdataxx;
+
+struct ct_params_t : ct_params_default_t
+{
+  using real_t = double;
+  enum { n_dims = 2 };
+  enum { n_eqns = 3 };
+  enum { rhs_scheme = solvers::trapez };
+  enum { vip_vab = solvers::impl };
+  enum { prs_scheme = solvers::cr };
+  struct ix { enum {
+    u, w, tht,
+    vip_i=u, vip_j=w, vip_den=-1
+  }; };
+  enum { hint_norhs = opts::bit(ix::tht) };
+};
+
+using ix = typename ct_params_t::ix;
+using slv_t = solvers::mpdata_rhs_vip_prs<ct_params_t>;
+using run_t = concurr::cxx11_thread<
+  slv_t,
+  bcond::cyclic, bcond::cyclic,
+  bcond::cyclic, bcond::cyclic
+>;
+
+const int nx = 32, ny = 24, nt = 10;
+
+typename slv_t::rt_params_t params(const int ny)
+{
+  typename slv_t::rt_params_t p;
+  p.dt = .1;
+  p.di = p.dj = 1;
+  p.prs_tol = 1e-7;
+  p.grid_size = {nx, ny};
+  return p;
+}
+
+void init(run_t &slv)
+{
+  blitz::firstIndex i;
+  blitz::secondIndex j;
+  slv.advectee(ix::u) = .5 * sin(2 * M_PI * j / ny);
+  slv.advectee(ix::w) = .5 * cos(2 * M_PI * i / nx);
+  slv.advectee(ix::tht) = exp(-(pow2(i - 11.) + pow2(j - 9.)) / 10);
+  slv.vab_coefficient() = .1 * (i > nx / 2);
+  slv.vab_relaxed_state(0) = 0;
+  slv.vab_relaxed_state(1) = 0;
+}
+
+int main()
+{
+#if defined(USE_MPI)
+  // we will instantiate many solvers, so we have to init mpi manually,
+  // because solvers will not know should they finalize mpi upon destruction
+  MPI::Init_thread(MPI_THREAD_MULTIPLE);
+#endif
+  // the number of threads is taken from OMP_NUM_THREADS by cxx11_thread
+  setenv("OMP_NUM_THREADS", "4", 1);
+
+  const std::string path = boost::filesystem::unique_path().native();
+
+  run_t ref(params(ny));
+  init(ref);
+  ref.advance(2 * nt);
+
+  {
+    run_t slv(params(ny));
+    init(slv);
+    slv.advance(nt);
+    slv.checkpoint(path);
+  }
+
+  run_t slv(params(ny));
+  slv.restart(path);
+  if (slv.time() != nt * .1)
+    throw std::runtime_error("time not restored");
+  slv.advance(nt);
+
+  for (int e = 0; e < ct_params_t::n_eqns; ++e)
+    if (any(slv.advectee(e) != ref.advectee(e)))
+      throw std::runtime_error("restarted run differs from the uninterrupted one");
+
+  // checkpoints are tied to the grid
+  bool thrown = false;
+  try
+  {
+    run_t other(params(ny + 1));
+    other.restart(path);
+  }
+  catch (std::runtime_error &)
+  {
+    thrown = true;
+  }
+  if (!thrown)
+    throw std::runtime_error("checkpoint of a different grid accepted");
+
+  boost::filesystem::remove(path);
+#if defined(USE_MPI)
+  MPI::Finalize();
+#endif
+}
@@ -0,0 +1,135 @@
+/**
+ * @file
+ * @copyright University of Warsaw
+ * @section LICENSE
+ * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
+ *
+ * checks the choice of 2D/3D thread decompositions and if multi-threaded
+ * runs on such decompositions give bitwise the same results as serial ones
+ */
+
+#include <libmpdata++/solvers/mpdata.hpp>
+#include <libmpdata++/concurr/serial.hpp>
+#include <libmpdata++/concurr/cxx11_thread.hpp>
+
+#include <cstdlib>
+
+using namespace libmpdataxx;
+
+template <int n_dims>
+void test_decompose(const std::array<int, n_dims> &grid_size, const int size, const std::array<int, n_dims> &expected)
+{
+  if (concurr::detail::sharedmem_common<double, n_dims, 1>::decompose(grid_size, size) != expected)
+    throw std::runtime_error("unexpected decomposition");
+}
+
+template <int n_dims>
+void test_fit_size(const std::array<int, n_dims> &grid_size, const int size, const int expected)
+{
+  if (concurr::detail::sharedmem_common<double, n_dims, 1>::fit_size(grid_size, size) != expected)
+    throw std::runtime_error("unexpected number of threads");
+}
+
+template <int n_dims_arg, opts::opts_t opts_arg>
+struct ct_params_t : ct_params_default_t
+{
+  using real_t = double;
+  enum { n_dims = n_dims_arg };
+  enum { n_eqns = 1 };
+  enum { opts = opts_arg };
+};
+
+template <class run_t>
+void run_2d(run_t &run)
+{
+  blitz::firstIndex i;
+  blitz::secondIndex j;
+  run.advectee() = 1 + exp(-(pow2(i - 11.) + pow2(j - 9.)) / 10);
+  run.advector(0) = .2;
+  run.advector(1) = -.3;
+  run.advance(20);
+}
+
+template <class run_t>
+void run_3d(run_t &run)
+{
+  blitz::firstIndex i;
+  blitz::secondIndex j;
+  blitz::thirdIndex k;
+  run.advectee() = 1 + exp(-(pow2(i - 11.) + pow2(j - 9.) + pow2(k - 4.)) / 10);
+  run.advector(0) = .2;
+  run.advector(1) = 0;
+  run.advector(2) = -.15;
+  run.advance(20);
+}
+
+template <opts::opts_t opts, bcond::bcond_e bcy>
+void test_2d()
+{
+  using slv_t = solvers::mpdata<ct_params_t<2, opts>>;
+  typename slv_t::rt_params_t p;
+  p.grid_size = {24, 18};
+  p.n_iters = 3;
+
+  concurr::serial<slv_t, bcond::cyclic, bcond::cyclic, bcy, bcy> ref(p);
+  concurr::cxx11_thread<slv_t, bcond::cyclic, bcond::cyclic, bcy, bcy> thr(p);
+  run_2d(ref);
+  run_2d(thr);
+
+  if (any(ref.advectee() != thr.advectee()))
+    throw std::runtime_error("2D multi-threaded result differs for opts = " + opts::opts_string(opts));
+}
+
+template <opts::opts_t opts, bcond::bcond_e bcy>
+void test_3d(const std::array<int, 3> &grid_size = {{12, 10, 8}})
+{
+  using slv_t = solvers::mpdata<ct_params_t<3, opts>>;
+  typename slv_t::rt_params_t p;
+  p.grid_size = grid_size;
+  p.n_iters = 3;
+
+  concurr::serial<slv_t, bcond::cyclic, bcond::cyclic, bcy, bcy, bcond::cyclic, bcond::cyclic> ref(p);
+  concurr::cxx11_thread<slv_t, bcond::cyclic, bcond::cyclic, bcy, bcy, bcond::cyclic, bcond::cyclic> thr(p);
+  run_3d(ref);
+  run_3d(thr);
+
+  if (any(ref.advectee() != thr.advectee()))
+    throw std::runtime_error("3D multi-threaded result differs for opts = " + opts::opts_string(opts));
+}
+
+int main()
+{
+  // boundary area is minimised, ties go to outer dimensions
+  test_decompose<1>({{100}}, 4, {{4}});
+  test_decompose<2>({{100, 2}}, 4, {{4, 1}});
+  test_decompose<2>({{24, 18}}, 6, {{3, 2}});
+  test_decompose<2>({{3, 40}}, 4, {{1, 4}});
+  test_decompose<3>({{12, 10, 8}}, 6, {{3, 2, 1}});
+  test_decompose<3>({{64, 64, 64}}, 4, {{2, 2, 1}});
+  // the innermost dimension is split only as a last resort
+  test_decompose<3>({{4, 4, 64}}, 7, {{1, 1, 7}});
+
+#if !defined(USE_MPI)
+  // numbers of threads that cannot be laid out on the grid are reduced to the largest one that can
+  test_fit_size<3>({{12, 10, 8}}, 6, 6);
+  test_fit_size<3>({{5, 5, 5}}, 7, 6);
+  test_fit_size<2>({{5, 5}}, 7, 6);
+  test_fit_size<2>({{3, 3}}, 8, 6);
+  test_fit_size<1>({{5}}, 7, 5);
+#endif
+
+#if !defined(USE_MPI)
+  // the number of threads is taken from OMP_NUM_THREADS by cxx11_thread
+  setenv("OMP_NUM_THREADS", "6", 1);
+
+  test_2d<opts::iga | opts::fct, bcond::cyclic>();
+  test_2d<opts::abs, bcond::rigid>();
+  test_3d<opts::iga | opts::fct, bcond::cyclic>();
+  test_3d<opts::fct, bcond::rigid>();
+  test_3d<opts::abs, bcond::open>();
+
+  // 7 threads requested, 6 used
+  setenv("OMP_NUM_THREADS", "7", 1);
+  test_3d<opts::fct, bcond::cyclic>({{5, 5, 5}});
+#endif
+}
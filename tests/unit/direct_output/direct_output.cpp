@@ -0,0 +1,76 @@
+/**
+ * @file
+ * @copyright University of Warsaw
+ * @section LICENSE
+ * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
+ *
+ * checks the fields written by HDF5 directly from the halo-padded solver arrays
+ * (and the ones copied before being quantized) against the solver state
+ */
+
+#include <libmpdata++/solvers/mpdata.hpp>
+#include <libmpdata++/concurr/cxx11_thread.hpp>
+#include <libmpdata++/output/hdf5.hpp>
+
+using namespace libmpdataxx;
+
+struct ct_params_t : ct_params_default_t
+{
+  using real_t = double;
+  enum { n_dims = 3 };
+  enum { n_eqns = 2 };
+  enum { opts = opts::nug };
+};
+
+const int nt = 3, nx = 17, ny = 9, nz = 6;
+
+int main()
+{
+  const std::string outdir = boost::filesystem::unique_path().native();
+  blitz::Array<float, 3> expected(nx, ny, nz), psi(nx, ny, nz), psi_q(nx, ny, nz), g(nx, ny, nz);
+
+  {
+    using slv_out_t = output::hdf5<solvers::mpdata<ct_params_t>>;
+    typename slv_out_t::rt_params_t p;
+    p.grid_size = {nx, ny, nz};
+    p.outfreq = nt;
+    p.outdir = outdir;
+    p.outvars[0].name = "psi";
+    p.outvars[1].name = "psi_q";
+    p.outvars[1].codec = output::codec_t::quantize;
+    p.outvars[1].tolerance = 1e-3;
+
+    concurr::cxx11_thread<
+      slv_out_t,
+      bcond::cyclic, bcond::cyclic,
+      bcond::cyclic, bcond::cyclic,
+      bcond::cyclic, bcond::cyclic
+    > slv(p);
+
+    blitz::firstIndex i;
+    blitz::secondIndex j;
+    blitz::thirdIndex k;
+    for (int e = 0; e < ct_params_t::n_eqns; ++e)
+      slv.advectee(e) = 1 + i + 10 * j + 100 * k;
+    slv.g_factor() = 1 + .1 * k;
+    for (int d = 0; d < 3; ++d) slv.advector(d) = .1;
+    slv.advance(nt);
+
+    expected = blitz::cast<float>(slv.advectee(0));
+  }
+
+  {
+    H5::H5File h5(outdir + "/timestep0000000003.h5", H5F_ACC_RDONLY);
+    h5.openDataSet("psi").read(psi.data(), H5::PredType::NATIVE_FLOAT);
+    h5.openDataSet("psi_q").read(psi_q.data(), H5::PredType::NATIVE_FLOAT);
+  }
+  H5::H5File(outdir + "/const.h5", H5F_ACC_RDONLY).openDataSet("G").read(g.data(), H5::PredType::NATIVE_FLOAT);
+
+  if (any(psi != expected))
+    throw std::runtime_error("field written from the solver memory");
+  if (max(abs(psi_q - expected) / abs(expected)) > 1e-3)
+    throw std::runtime_error("quantized field");
+  blitz::thirdIndex k;
+  if (any(g != blitz::cast<float>(1 + .1 * k)))
+    throw std::runtime_error("G factor written from the solver memory");
+}
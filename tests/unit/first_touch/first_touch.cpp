@@ -0,0 +1,86 @@
+/**
+ * @file
+ * @copyright University of Warsaw
+ * @section LICENSE
+ * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
+ *
+ * checks if placing the shared arrays on the NUMA nodes of the threads (first touch)
+ * preserves the values set in the solvers' constructors (here: the boussinesq ones),
+ * i.e. if the openmp and cxx11_thread backends give the same results as the serial one;
+ * built with assertions and NaN-filled arrays regardless of the build type
+ */
+
+#if defined(NDEBUG)
+#  undef NDEBUG
+#endif
+
+#include <libmpdata++/solvers/boussinesq.hpp>
+#include <libmpdata++/concurr/serial.hpp>
+#include <libmpdata++/concurr/openmp.hpp>
+#include <libmpdata++/concurr/cxx11_thread.hpp>
+
+using namespace libmpdataxx;
+
+struct ct_params_t : ct_params_default_t
+{
+  using real_t = double;
+  enum { n_dims = 2 };
+  enum { n_eqns = 3 };
+  enum { rhs_scheme = solvers::trapez };
+  enum { prs_scheme = solvers::cr };
+  struct ix { enum {
+    u, w, tht,
+    vip_i=u, vip_j=w, vip_den=-1
+  }; };
+};
+
+using ix = typename ct_params_t::ix;
+using slv_t = solvers::boussinesq<ct_params_t>;
+
+const int nx = 48, ny = 40, nt = 10;
+const double Tht_ref = 300;
+
+template <class run_t>
+blitz::Array<double, 2> run(const std::string &backend)
+{
+  typename slv_t::rt_params_t p;
+  p.dt = .75;
+  p.di = p.dj = 10.;
+  p.Tht_ref = Tht_ref;
+  p.prs_tol = 1e-7;
+  p.grid_size = {nx, ny};
+
+  run_t slv(p);
+
+  // set in the constructors
+  if (any(slv.sclr_array("tht_abs") != 0) || any(slv.sclr_array("hflux_frc") != 0))
+    throw std::runtime_error(backend + ": values set in the solver constructors lost");
+
+  blitz::firstIndex i;
+  blitz::secondIndex j;
+  slv.sclr_array("tht_e") = Tht_ref;
+  slv.advectee(ix::tht) = Tht_ref + where(pow2(i - nx / 2.) + pow2(j - ny / 3.) <= 64, .5, 0);
+  slv.advectee(ix::u) = 0;
+  slv.advectee(ix::w) = 0;
+
+  slv.advance(nt);
+
+  if (!std::isfinite(sum(slv.advectee(ix::tht))) || !std::isfinite(sum(slv.advectee(ix::w))))
+    throw std::runtime_error(backend + ": non-finite values");
+
+  return slv.advectee(ix::tht).copy();
+}
+
+int main()
+{
+  // the number of threads is taken from OMP_NUM_THREADS by cxx11_thread
+  setenv("OMP_NUM_THREADS", "4", 1);
+
+  const auto ref = run<concurr::serial<slv_t, bcond::cyclic, bcond::cyclic, bcond::cyclic, bcond::cyclic>>("serial");
+  const auto omp = run<concurr::openmp<slv_t, bcond::cyclic, bcond::cyclic, bcond::cyclic, bcond::cyclic>>("openmp");
+  const auto thr = run<concurr::cxx11_thread<slv_t, bcond::cyclic, bcond::cyclic, bcond::cyclic, bcond::cyclic>>("cxx11_thread");
+
+  // up to the order of summation in the pressure solver
+  if (max(abs(omp - ref)) > 1e-8 || max(abs(thr - ref)) > 1e-8)
+    throw std::runtime_error("results depend on the backend");
+}
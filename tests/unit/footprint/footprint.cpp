@@ -0,0 +1,70 @@
+/**
+ * @file
+ * @copyright University of Warsaw
+ * @section LICENSE
+ * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
+ *
+ * checks if the memory footprint computed in a dry run matches the one
+ * of an actual run and if the pressure solver temporaries share storage
+ * with the advection ones
+ */
+
+#include <libmpdata++/solvers/mpdata_rhs_vip_prs.hpp>
+#include <libmpdata++/concurr/serial.hpp>
+
+#include <iostream>
+
+using namespace libmpdataxx;
+
+struct ct_params_t : ct_params_default_t
+{
+  using real_t = double;
+  enum { n_dims = 2 };
+  enum { n_eqns = 2 };
+  enum { opts = opts::fct };
+  enum { rhs_scheme = solvers::euler_b };
+  enum { prs_scheme = solvers::cr };
+  struct ix { enum {
+    u, w,
+    vip_i=u, vip_j=w, vip_den=-1
+  }; };
+};
+
+int main()
+{
+  using slv_t = solvers::mpdata_rhs_vip_prs<ct_params_t>;
+  using run_t = concurr::serial<
+    slv_t,
+    bcond::cyclic, bcond::cyclic,
+    bcond::cyclic, bcond::cyclic
+  >;
+
+  typename slv_t::rt_params_t p;
+  p.di = p.dj = 1;
+  p.dt = .1;
+  p.prs_tol = 1e-6;
+  p.grid_size = {32, 24};
+
+  const auto dry = run_t::footprint_dry_run(p);
+  run_t run(p);
+  const auto fp = run.footprint();
+  fp.print(std::cout);
+
+  if (dry.bytes_arrays != fp.bytes_arrays || dry.bytes_allocated != fp.bytes_allocated)
+    throw std::runtime_error("dry-run footprint differs from the actual one");
+
+  if (dry.entries.size() != fp.entries.size())
+    throw std::runtime_error("dry-run breakdown differs from the actual one");
+  for (std::size_t i = 0; i < fp.entries.size(); ++i)
+    if (dry.entries[i].owner != fp.entries[i].owner || dry.entries[i].shapes != fp.entries[i].shapes)
+      throw std::runtime_error("dry-run breakdown differs from the actual one");
+
+  // psi includes halos
+  const int halo = slv_t::halo;
+  if (fp.entries[0].owner != "psi" || fp.entries[0].shapes[0] != std::vector<int>({32 + 2 * halo, 24 + 2 * halo}))
+    throw std::runtime_error("unexpected psi shape");
+
+  // pressure solver temporaries reuse the FCT ones
+  if (fp.bytes_allocated >= fp.bytes_arrays)
+    throw std::runtime_error("no storage shared between phases");
+}
@@ -0,0 +1,86 @@
+/** 
+ * @file
+ * @copyright University of Warsaw
+ * @section LICENSE
+ * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
+ *
+ * checks if the fused 3D advop kernel and cache-tiled traversal give bitwise the same results as the standard one
+ */
+
+#include <libmpdata++/solvers/mpdata.hpp>
+#include <libmpdata++/concurr/threads.hpp>
+
+using namespace libmpdataxx;
+
+template <opts::opts_t opts_arg, bool fused>
+struct ct_params_t : ct_params_default_t
+{
+  using real_t = double;
+  enum { n_dims = 3 };
+  enum { n_eqns = 1 };
+  enum { opts = opts_arg };
+  enum { fused_advop = fused };
+};
+
+template <opts::opts_t opts, bool fused, bcond::bcond_e bcy>
+blitz::Array<double, 3> run(const int n_iters, const std::array<int, 3> tile_size = {{0, 0, 0}})
+{
+  using slv_t = solvers::mpdata<ct_params_t<opts, fused>>;
+  typename slv_t::rt_params_t p;
+  p.grid_size = {23, 19, 17};
+  p.n_iters = n_iters;
+  p.tile_size = tile_size;
+
+  concurr::threads<
+    slv_t,
+    bcond::cyclic, bcond::cyclic,
+    bcy, bcy,
+    bcond::cyclic, bcond::cyclic
+  > slv(p);
+
+  blitz::firstIndex i;
+  blitz::secondIndex j;
+  blitz::thirdIndex k;
+  slv.advectee() = 1 + exp(-(pow2(i - 11.) + pow2(j - 9.) + pow2(k - 8.)) / 10);
+  slv.advector(0) = .2;
+  slv.advector(1) = 0;
+  slv.advector(2) = -.15;
+
+  slv.advance(20);
+  return slv.advectee().copy();
+}
+
+template <opts::opts_t opts, bcond::bcond_e bcy = bcond::cyclic>
+void test(const int n_iters = 2)
+{
+  auto ref = run<opts, false, bcy>(n_iters);
+  auto fsd = run<opts, true, bcy>(n_iters);
+  auto tld = run<opts, false, bcy>(n_iters, {{5, 3, 4}});
+  auto fsd_tld = run<opts, true, bcy>(n_iters, {{2, 0, 7}});
+
+  if (any(ref != fsd))
+    throw std::runtime_error("fused advop result differs for opts = " + opts::opts_string(opts));
+  if (any(ref != tld) || any(ref != fsd_tld))
+    throw std::runtime_error("tiled advop result differs for opts = " + opts::opts_string(opts));
+}
+
+int main()
+{
+#if defined(USE_MPI)
+  // we will instantiate many solvers, so we have to init mpi manually, 
+  // because solvers will not know should they finalize mpi upon destruction
+  MPI::Init_thread(MPI_THREAD_MULTIPLE);
+#endif
+
+  test<opts::iga | opts::fct>();
+  test<opts::iga | opts::fct, bcond::rigid>();
+  test<opts::fct>();
+  test<opts::abs>(3);
+  test<opts::abs, bcond::rigid>(3);
+  test<opts::tot | opts::khn>();
+  test<opts::iga | opts::div_2nd | opts::div_3rd | opts::fct>();
+
+#if defined(USE_MPI)
+  MPI::Finalize();
+#endif
+}
@@ -0,0 +1,87 @@
+/**
+ * @file
+ * @copyright University of Warsaw
+ * @section LICENSE
+ * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
+ *
+ * checks the records kept in memory by output::memory: a field shifted by one cell
+ * per timestep (donor-cell with the Courant number of one), the last records of which
+ * are compared with the shifted initial field (in full and downsampled)
+ */
+
+#include <libmpdata++/solvers/mpdata.hpp>
+#include <libmpdata++/concurr/cxx11_thread.hpp>
+#include <libmpdata++/output/memory.hpp>
+
+using namespace libmpdataxx;
+
+struct ct_params_t : ct_params_default_t
+{
+  using real_t = double;
+  enum { n_dims = 2 };
+  enum { n_eqns = 2 };
+  enum { opts = 0 };
+};
+
+const int nt = 5, nx = 16, ny = 7, n_hist = 3;
+
+int main()
+{
+  setenv("OMP_NUM_THREADS", "3", 1);
+
+  using slv_out_t = output::memory<solvers::mpdata<ct_params_t>>;
+  typename slv_out_t::rt_params_t p;
+  p.grid_size = {nx, ny};
+  p.n_iters = 1;
+  p.dt = 1;
+  p.out_history = n_hist;
+  p.outvars[0].name = "psi";
+  p.outvars[1].name = "psi_dec"; // every other column, from the 3rd row on
+  p.outvars[1].roi_first = {{0, 2, 0}};
+  p.outvars[1].stride = {{2, 1, 1}};
+
+  concurr::cxx11_thread<slv_out_t, bcond::cyclic, bcond::cyclic, bcond::cyclic, bcond::cyclic> slv(p);
+
+  blitz::firstIndex i;
+  blitz::secondIndex j;
+  for (int e = 0; e < ct_params_t::n_eqns; ++e)
+    slv.advectee(e) = i + 100 * j; // integers, shifted exactly
+  slv.advector(0) = 1;
+  slv.advector(1) = 0;
+
+  slv.advance(nt);
+
+  if (slv.history_size("psi") != n_hist || slv.history_size("psi_dec") != n_hist)
+    throw std::runtime_error("number of records kept");
+
+  for (int n = 0; n < n_hist; ++n)
+  {
+    const int t = nt - n;
+    if (slv.history_time("psi", n) != t)
+      throw std::runtime_error("time of a record");
+
+    blitz::Array<double, 2> expected(nx, ny);
+    expected = (i - t + nx) % nx + 100 * j;
+
+    const auto psi = slv.history("psi", n);
+    if (psi.extent(0) != nx || psi.extent(1) != ny || any(psi != expected))
+      throw std::runtime_error("record kept in memory");
+
+    const auto psi_dec = slv.history("psi_dec", n);
+    if (psi_dec.extent(0) != nx / 2 || psi_dec.extent(1) != ny - 2)
+      throw std::runtime_error("extents of a downsampled record");
+    if (any(psi_dec != expected(blitz::Range(0, nx - 1, 2), blitz::Range(2, ny - 1))))
+      throw std::runtime_error("downsampled record kept in memory");
+  }
+
+  // only the kept records are available
+  try
+  {
+    slv.history("psi", n_hist);
+  }
+  catch (std::out_of_range &)
+  {
+    return 0;
+  }
+  throw std::runtime_error("record not kept in memory accessible");
+}
@@ -0,0 +1,87 @@
+/** 
+ * @file
+ * @copyright University of Warsaw
+ * @section LICENSE
+ * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
+ *
+ * checks if filling the halos while advecting the interior of the subdomain (overlap_xchng)
+ * gives bitwise the same results as filling them beforehand
+ */
+
+#include <libmpdata++/solvers/mpdata.hpp>
+#include <libmpdata++/concurr/threads.hpp>
+
+using namespace libmpdataxx;
+
+template <opts::opts_t opts_arg, bool overlap>
+struct ct_params_t : ct_params_default_t
+{
+  using real_t = double;
+  enum { n_dims = 3 };
+  enum { n_eqns = 2 };
+  enum { opts = opts_arg };
+  enum { overlap_xchng = overlap };
+};
+
+template <opts::opts_t opts, bool overlap, bcond::bcond_e bcx, bcond::bcond_e bcy>
+std::array<blitz::Array<double, 3>, 2> run(const int n_iters, const std::array<int, 3> tile_size = {{0, 0, 0}})
+{
+  using slv_t = solvers::mpdata<ct_params_t<opts, overlap>>;
+  typename slv_t::rt_params_t p;
+  p.grid_size = {23, 19, 17};
+  p.n_iters = n_iters;
+  p.tile_size = tile_size;
+
+  concurr::threads<
+    slv_t,
+    bcx, bcx,
+    bcy, bcy,
+    bcond::cyclic, bcond::cyclic
+  > slv(p);
+
+  blitz::firstIndex i;
+  blitz::secondIndex j;
+  blitz::thirdIndex k;
+  slv.advectee(0) = 1 + exp(-(pow2(i - 11.) + pow2(j - 9.) + pow2(k - 8.)) / 10);
+  slv.advectee(1) = 2 + sin(i / 3.) * cos(j / 4.);
+  slv.advector(0) = .2;
+  slv.advector(1) = .1;
+  slv.advector(2) = -.15;
+
+  slv.advance(20);
+
+  return {{slv.advectee(0).copy(), slv.advectee(1).copy()}};
+}
+
+template <opts::opts_t opts, bcond::bcond_e bcx = bcond::cyclic, bcond::bcond_e bcy = bcond::cyclic>
+void test(const int n_iters = 2)
+{
+  auto ref = run<opts, false, bcx, bcy>(n_iters);
+  auto ovl = run<opts, true, bcx, bcy>(n_iters);
+  auto ovl_tld = run<opts, true, bcx, bcy>(n_iters, {{5, 3, 4}});
+
+  for (int e = 0; e < 2; ++e)
+    if (any(ref[e] != ovl[e]) || any(ref[e] != ovl_tld[e]))
+      throw std::runtime_error("overlap_xchng result differs for opts = " + opts::opts_string(opts));
+}
+
+int main()
+{
+#if defined(USE_MPI)
+  // we will instantiate many solvers, so we have to init mpi manually, 
+  // because solvers will not know should they finalize mpi upon destruction
+  MPI::Init_thread(MPI_THREAD_MULTIPLE);
+#endif
+
+  test<opts::abs>(1);
+  test<opts::abs>(3);
+  test<opts::abs, bcond::rigid>();
+  test<opts::abs, bcond::cyclic, bcond::rigid>();
+  test<opts::iga>();
+  test<opts::tot | opts::khn>();
+  test<opts::abs | opts::div_2nd | opts::div_3rd>();
+
+#if defined(USE_MPI)
+  MPI::Finalize();
+#endif
+}
@@ -0,0 +1,104 @@
+/**
+ * @file
+ * @copyright University of Warsaw
+ * @section LICENSE
+ * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
+ *
+ * checks if the output compressed in parallel by the solver threads
+ * (in chunks aligned with a 2D thread decomposition not evenly dividing
+ * the domain) matches the regular output
+ */
+
+#include <libmpdata++/solvers/mpdata.hpp>
+#include <libmpdata++/concurr/cxx11_thread.hpp>
+#include <libmpdata++/output/hdf5.hpp>
+
+using namespace libmpdataxx;
+
+struct ct_params_t : ct_params_default_t
+{
+  using real_t = double;
+  enum { n_dims = 2 };
+  enum { n_eqns = 1 };
+};
+
+const int nt = 12, outfreq = 4, nx = 31, ny = 23;
+
+void run(const std::string &outdir, const bool pack, const bool single_file)
+{
+  using slv_out_t = output::hdf5<solvers::mpdata<ct_params_t>>;
+  typename slv_out_t::rt_params_t p;
+  p.grid_size = {nx, ny};
+  p.outfreq = outfreq;
+  p.outdir = outdir;
+  p.outvars[0].name = "psi";
+  p.outvars[0].pack = pack;
+  p.out_single_file = single_file;
+
+  concurr::cxx11_thread<
+    slv_out_t,
+    bcond::cyclic, bcond::cyclic,
+    bcond::cyclic, bcond::cyclic
+  > slv(p);
+
+  blitz::firstIndex i;
+  blitz::secondIndex j;
+  slv.advectee() = exp(-(pow2(i - 11.) + pow2(j - 9.)) / 10);
+  slv.advector(0) = .2;
+  slv.advector(1) = -.3;
+  slv.advance(nt);
+}
+
+void read(const H5::DataSet &dset, blitz::Array<float, 2> &arr, const int r = -1)
+{
+  H5::DataSpace space = dset.getSpace();
+  if (r >= 0)
+  {
+    hsize_t count[3] = {1, nx, ny}, start[3] = {hsize_t(r), 0, 0};
+    space.selectHyperslab(H5S_SELECT_SET, count, start);
+  }
+  hsize_t count[2] = {nx, ny};
+  dset.read(arr.data(), H5::PredType::NATIVE_FLOAT, H5::DataSpace(2, count), space);
+}
+
+int main()
+{
+  // the number of threads is taken from OMP_NUM_THREADS by cxx11_thread
+  // (6 threads on 31x23 cells: 3x2 subdomains of 10 or 11 by 11 or 12 cells)
+  setenv("OMP_NUM_THREADS", "6", 1);
+
+  const std::string ref_dir = boost::filesystem::unique_path().native();
+  const std::string pck_dir = boost::filesystem::unique_path().native();
+  const std::string srs_dir = boost::filesystem::unique_path().native();
+
+  run(ref_dir, false, false);
+  run(pck_dir, true, false);
+  run(srs_dir, true, true);
+
+  H5::H5File series(srs_dir + "/series.h5", H5F_ACC_RDONLY);
+
+  blitz::Array<float, 2> ref(nx, ny), pck(nx, ny), srs(nx, ny);
+  for (int r = 0; r <= nt / outfreq; ++r)
+  {
+    std::ostringstream name;
+    name << "/timestep" << std::setw(10) << std::setfill('0') << r * outfreq << ".h5";
+
+    read(H5::H5File(ref_dir + name.str(), H5F_ACC_RDONLY).openDataSet("psi"), ref);
+    read(H5::H5File(pck_dir + name.str(), H5F_ACC_RDONLY).openDataSet("psi"), pck);
+    read(series.openDataSet("psi"), srs, r);
+
+    // chunks of the extents of the largest thread subdomain
+    if (r == 0)
+    {
+      hsize_t chnk[2];
+      H5::H5File(pck_dir + name.str(), H5F_ACC_RDONLY).openDataSet("psi").getCreatePlist().getChunk(2, chnk);
+      if (chnk[0] != 11 || chnk[1] != 12)
+        throw std::runtime_error("packed chunks not aligned with the thread decomposition");
+    }
+
+    if (any(pck != ref))
+      throw std::runtime_error("packed record differs from the regular one");
+    if (any(srs != ref))
+      throw std::runtime_error("packed series record differs from the regular one");
+  }
+}
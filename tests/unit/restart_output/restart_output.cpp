@@ -0,0 +1,128 @@
+/**
+ * @file
+ * @copyright University of Warsaw
+ * @section LICENSE
+ * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
+ *
+ * checks if the output of a run restarted from a checkpoint continues that of the run
+ * before the checkpoint: records made with record_aux_const() kept in the const file
+ * and the temporal xmf listing all the records (as in an uninterrupted run)
+ */
+
+#include <libmpdata++/solvers/mpdata.hpp>
+#include <libmpdata++/concurr/cxx11_thread.hpp>
+#include <libmpdata++/output/hdf5_xdmf.hpp>
+
+#include <fstream>
+
+using namespace libmpdataxx;
+
+struct ct_params_t : ct_params_default_t
+{
+  using real_t = double;
+  enum { n_dims = 2 };
+  enum { n_eqns = 1 };
+};
+
+const int nt = 10, outfreq = 2;
+
+class slv_out_t : public output::hdf5_xdmf<solvers::mpdata<ct_params_t>>
+{
+  using parent_t = output::hdf5_xdmf<solvers::mpdata<ct_params_t>>;
+
+  // recorded once, at the beginning of the run (not repeated after a restart)
+  void hook_ante_loop(const typename parent_t::advance_arg_t nt)
+  {
+    parent_t::hook_ante_loop(nt);
+    if (this->rank == 0) this->record_aux_const("ante_loop", 44);
+    this->mem->barrier();
+  }
+
+  public:
+
+  // ctor
+  slv_out_t(
+    typename parent_t::ctor_args_t args,
+    const typename parent_t::rt_params_t &p
+  ) : parent_t(args, p)
+  {}
+};
+
+using run_t = concurr::cxx11_thread<
+  slv_out_t,
+  bcond::cyclic, bcond::cyclic,
+  bcond::cyclic, bcond::cyclic
+>;
+
+typename slv_out_t::rt_params_t params(const std::string &outdir)
+{
+  typename slv_out_t::rt_params_t p;
+  p.grid_size = {32, 24};
+  p.outfreq = outfreq;
+  p.outdir = outdir;
+  return p;
+}
+
+void init(run_t &slv)
+{
+  blitz::firstIndex i;
+  blitz::secondIndex j;
+  slv.advectee() = exp(-(pow2(i - 11.) + pow2(j - 9.)) / 10);
+  slv.advector(0) = .2;
+  slv.advector(1) = -.3;
+}
+
+std::string slurp(const std::string &name)
+{
+  std::ifstream f(name);
+  if (!f) throw std::runtime_error("cannot open " + name);
+  return std::string(std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>());
+}
+
+int main()
+{
+  const std::string ref_dir = boost::filesystem::unique_path().native();
+  const std::string rst_dir = boost::filesystem::unique_path().native();
+  const std::string path = boost::filesystem::unique_path().native();
+
+  {
+    run_t ref(params(ref_dir));
+    init(ref);
+    ref.advance(2 * nt);
+  }
+
+  {
+    run_t slv(params(rst_dir));
+    init(slv);
+    slv.advance(nt);
+    slv.checkpoint(path);
+    // records made after the checkpoint by the interrupted run
+    slv.advance(nt / 2);
+  }
+
+  {
+    run_t slv(params(rst_dir));
+    slv.restart(path);
+    slv.advance(nt);
+  }
+
+  // the const file reopened, not recreated
+  {
+    H5::H5File h5(rst_dir + "/const.h5", H5F_ACC_RDONLY);
+    float val;
+    h5.openGroup("/").openAttribute("ante_loop").read(H5::PredType::NATIVE_FLOAT, &val);
+    if (val != 44)
+      throw std::runtime_error("record_aux_const() record lost after the restart");
+
+    hsize_t dims[2];
+    h5.openDataSet("X").getSpace().getSimpleExtentDims(dims, NULL);
+    if (dims[0] != 33 || dims[1] != 25)
+      throw std::runtime_error("coordinates lost after the restart");
+  }
+
+  // all the records listed in the temporal xmf
+  if (slurp(rst_dir + "/temp.xmf") != slurp(ref_dir + "/temp.xmf"))
+    throw std::runtime_error("temporal xmf of the restarted run differs from the uninterrupted one");
+
+  boost::filesystem::remove(path);
+}
@@ -0,0 +1,116 @@
+/**
+ * @file
+ * @copyright University of Warsaw
+ * @section LICENSE
+ * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
+ *
+ * checks that variables recorded on a part of the domain and/or every n-th cell
+ * match the corresponding part of the full fields (in the per-timestep and single-file modes)
+ */
+
+#include <libmpdata++/solvers/mpdata.hpp>
+#include <libmpdata++/concurr/serial.hpp>
+#include <libmpdata++/output/hdf5_xdmf.hpp>
+
+using namespace libmpdataxx;
+
+struct ct_params_t : ct_params_default_t
+{
+  using real_t = double;
+  enum { n_dims = 3 };
+  enum { n_eqns = 4 }; // the same field advected in all equations and recorded differently
+};
+
+const int nt = 4, nx = 13, ny = 8, nz = 11;
+
+// the last record of a variable
+void read(const std::string &file, const std::string &name, blitz::Array<float, 3> &arr)
+{
+  H5::H5File h5(file, H5F_ACC_RDONLY);
+  auto dset = h5.openDataSet(name);
+  auto space = dset.getSpace();
+  const int rank = space.getSimpleExtentNdims();
+  hsize_t dims[4], start[4] = {0, 0, 0, 0};
+  space.getSimpleExtentDims(dims, NULL);
+  if (rank == 4)
+  {
+    start[0] = dims[0] - 1;
+    dims[0] = 1;
+  }
+  space.selectHyperslab(H5S_SELECT_SET, dims, start);
+  arr.resize(dims[rank - 3], dims[rank - 2], dims[rank - 1]);
+  dset.read(arr.data(), H5::PredType::NATIVE_FLOAT, H5::DataSpace(rank, dims), space);
+}
+
+void test(const bool single_file)
+{
+  const std::string outdir = boost::filesystem::unique_path().native();
+  {
+    using slv_out_t = output::hdf5_xdmf<solvers::mpdata<ct_params_t>>;
+    typename slv_out_t::rt_params_t p;
+    p.grid_size = {nx, ny, nz};
+    p.outfreq = nt;
+    p.outdir = outdir;
+    p.out_single_file = single_file;
+
+    p.outvars[0].name = "psi";
+    p.outvars[1].name = "psi_lowest";  // the lowest levels
+    p.outvars[1].roi_last = {{-1, -1, 3}};
+    p.outvars[2].name = "psi_xsec";    // a vertical cross-section, every other cell
+    p.outvars[2].roi_first = {{0, 5, 0}};
+    p.outvars[2].roi_last = {{-1, 5, -1}};
+    p.outvars[2].stride = {{2, 1, 2}};
+    p.outvars[3].name = "psi_box";     // every 3rd cell within a box
+    p.outvars[3].roi_first = {{1, 2, 3}};
+    p.outvars[3].roi_last = {{11, 7, 9}};
+    p.outvars[3].stride = {{3, 3, 3}};
+
+    concurr::serial<
+      slv_out_t,
+      bcond::cyclic, bcond::cyclic,
+      bcond::cyclic, bcond::cyclic,
+      bcond::cyclic, bcond::cyclic
+    > slv(p);
+
+    blitz::firstIndex i;
+    blitz::secondIndex j;
+    blitz::thirdIndex k;
+    for (int e = 0; e < ct_params_t::n_eqns; ++e)
+      slv.advectee(e) = sin(i * .7) + cos(j * .4) * k;
+    for (int d = 0; d < 3; ++d) slv.advector(d) = .2;
+    slv.advance(nt);
+  }
+
+  const std::string file = outdir + (single_file ? "/series.h5" : "/timestep0000000004.h5");
+  blitz::Array<float, 3> psi, part;
+  read(file, "psi", psi);
+
+  const blitz::Range all = blitz::Range::all();
+  read(file, "psi_lowest", part);
+  if (any(part != psi(all, all, blitz::Range(0, 3))))
+    throw std::runtime_error("region of interest");
+
+  read(file, "psi_xsec", part);
+  if (part.extent(0) != 7 || part.extent(1) != 1 || part.extent(2) != 6)
+    throw std::runtime_error("strided cross-section extents");
+  if (any(part != psi(blitz::Range(0, nx - 1, 2), blitz::Range(5, 5), blitz::Range(0, nz - 1, 2))))
+    throw std::runtime_error("strided cross-section");
+
+  read(file, "psi_box", part);
+  if (part.extent(0) != 4 || part.extent(1) != 2 || part.extent(2) != 3)
+    throw std::runtime_error("strided region of interest extents");
+  if (any(part != psi(blitz::Range(1, 11, 3), blitz::Range(2, 7, 3), blitz::Range(3, 9, 3))))
+    throw std::runtime_error("strided region of interest");
+
+  // cell edges of the strided region of interest, the last cells cut at the end of the region
+  blitz::Array<float, 3> x;
+  read(outdir + "/const.h5", "X_psi_box", x);
+  if (x.extent(0) != 5 || x(0, 0, 0) != 1 || x(3, 0, 0) != 10 || x(4, 0, 0) != 11)
+    throw std::runtime_error("coordinates of the strided region of interest");
+}
+
+int main()
+{
+  test(false);
+  test(true);
+}
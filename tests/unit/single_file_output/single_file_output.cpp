@@ -0,0 +1,86 @@
+/**
+ * @file
+ * @copyright University of Warsaw
+ * @section LICENSE
+ * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
+ *
+ * checks if the records appended to a single file match the ones
+ * written to separate per-timestep files
+ */
+
+#include <libmpdata++/solvers/mpdata.hpp>
+#include <libmpdata++/concurr/serial.hpp>
+#include <libmpdata++/output/hdf5_xdmf.hpp>
+
+using namespace libmpdataxx;
+
+struct ct_params_t : ct_params_default_t
+{
+  using real_t = double;
+  enum { n_dims = 2 };
+  enum { n_eqns = 1 };
+};
+
+const int nt = 20, outfreq = 4, nx = 32, ny = 24;
+
+void run(const std::string &outdir, const bool single_file)
+{
+  using slv_out_t = output::hdf5_xdmf<solvers::mpdata<ct_params_t>>;
+  typename slv_out_t::rt_params_t p;
+  p.grid_size = {nx, ny};
+  p.outfreq = outfreq;
+  p.outdir = outdir;
+  p.out_single_file = single_file;
+
+  concurr::serial<
+    slv_out_t,
+    bcond::cyclic, bcond::cyclic,
+    bcond::cyclic, bcond::cyclic
+  > slv(p);
+
+  blitz::firstIndex i;
+  blitz::secondIndex j;
+  slv.advectee() = exp(-(pow2(i - 11.) + pow2(j - 9.)) / 10);
+  slv.advector(0) = .2;
+  slv.advector(1) = -.3;
+  slv.advance(nt);
+}
+
+int main()
+{
+  const std::string multi_dir = boost::filesystem::unique_path().native();
+  const std::string single_dir = boost::filesystem::unique_path().native();
+
+  run(multi_dir, false);
+  run(single_dir, true);
+
+  H5::H5File series(single_dir + "/series.h5", H5F_ACC_RDONLY);
+  auto psi = series.openDataSet("psi");
+  hsize_t dims[3];
+  psi.getSpace().getSimpleExtentDims(dims, NULL);
+  if (dims[0] != nt / outfreq + 1 || dims[1] != nx || dims[2] != ny)
+    throw std::runtime_error("unexpected extents of the series dataset");
+
+  blitz::Array<float, 2> rec(nx, ny), ref(nx, ny);
+  for (int r = 0; r <= nt / outfreq; ++r)
+  {
+    // reading a single record
+    hsize_t count[3] = {1, nx, ny}, start[3] = {hsize_t(r), 0, 0};
+    H5::DataSpace space = psi.getSpace();
+    space.selectHyperslab(H5S_SELECT_SET, count, start);
+    psi.read(rec.data(), H5::PredType::NATIVE_FLOAT, H5::DataSpace(3, count), space);
+
+    std::ostringstream name;
+    name << multi_dir << "/timestep" << std::setw(10) << std::setfill('0') << r * outfreq << ".h5";
+    H5::H5File h5(name.str(), H5F_ACC_RDONLY);
+    h5.openDataSet("psi").read(ref.data(), H5::PredType::NATIVE_FLOAT);
+
+    if (any(rec != ref))
+      throw std::runtime_error("record differs from the per-timestep file");
+  }
+
+  if (boost::filesystem::exists(single_dir + "/timestep0000000000.h5"))
+    throw std::runtime_error("per-timestep file written in the single-file mode");
+  if (!boost::filesystem::exists(single_dir + "/series.xmf"))
+    throw std::runtime_error("xdmf markup not written");
+}
@@ -0,0 +1,104 @@
+/**
+ * @file
+ * @copyright University of Warsaw
+ * @section LICENSE
+ * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
+ *
+ * checks the in-situ statistics computed by multiple threads against
+ * the ones computed from the full fields recorded at the same timesteps
+ */
+
+#include <libmpdata++/solvers/mpdata.hpp>
+#include <libmpdata++/concurr/cxx11_thread.hpp>
+#include <libmpdata++/output/hdf5.hpp>
+
+using namespace libmpdataxx;
+
+struct ct_params_t : ct_params_default_t
+{
+  using real_t = double;
+  enum { n_dims = 3 };
+  enum { n_eqns = 2 };
+};
+
+const int nt = 6, outfreq = 3, nx = 12, ny = 10, nz = 8, n_bins = 5;
+
+int main()
+{
+  // the number of threads is taken from OMP_NUM_THREADS by cxx11_thread
+  setenv("OMP_NUM_THREADS", "4", 1);
+
+  const std::string outdir = boost::filesystem::unique_path().native();
+  {
+    using slv_out_t = output::hdf5<solvers::mpdata<ct_params_t>>;
+    typename slv_out_t::rt_params_t p;
+    p.grid_size = {nx, ny, nz};
+    p.outfreq = outfreq;
+    p.statfreq = outfreq;
+    p.outdir = outdir;
+    p.outvars = {{0, {"a", ""}}, {1, {"b", ""}}};
+    p.out_stats = {
+      {"a_mean", output::stat_t::level_mean, 0},
+      {"ab_cov", output::stat_t::level_covariance, 0, 1},
+      {"a_min", output::stat_t::level_min, 0},
+      {"a_max", output::stat_t::level_max, 0},
+      {"b_hist", output::stat_t::histogram, 1, -1, 0, 1, n_bins}
+    };
+
+    concurr::cxx11_thread<
+      slv_out_t,
+      bcond::cyclic, bcond::cyclic,
+      bcond::cyclic, bcond::cyclic,
+      bcond::cyclic, bcond::cyclic
+    > slv(p);
+
+    blitz::firstIndex i;
+    blitz::secondIndex j;
+    blitz::thirdIndex k;
+    slv.advectee(0) = exp(-(pow2(i - 5.) + pow2(j - 4.) + pow2(k - 3.)) / 8);
+    slv.advectee(1) = sin(i * .5) * cos(j * .3) + .1 * k;
+    for (int d = 0; d < 3; ++d) slv.advector(d) = .1 * (d + 1);
+    slv.advance(nt);
+  }
+
+  H5::H5File stats(outdir + "/stats.h5", H5F_ACC_RDONLY);
+  hsize_t n_rec;
+  stats.openDataSet("T").getSpace().getSimpleExtentDims(&n_rec, NULL);
+  if (n_rec != nt / outfreq + 1)
+    throw std::runtime_error("unexpected number of statistics records");
+
+  blitz::Array<double, 2> mean(n_rec, nz), cov(n_rec, nz), mn(n_rec, nz), mx(n_rec, nz), hist(n_rec, n_bins);
+  stats.openDataSet("a_mean").read(mean.data(), H5::PredType::NATIVE_DOUBLE);
+  stats.openDataSet("ab_cov").read(cov.data(), H5::PredType::NATIVE_DOUBLE);
+  stats.openDataSet("a_min").read(mn.data(), H5::PredType::NATIVE_DOUBLE);
+  stats.openDataSet("a_max").read(mx.data(), H5::PredType::NATIVE_DOUBLE);
+  stats.openDataSet("b_hist").read(hist.data(), H5::PredType::NATIVE_DOUBLE);
+
+  // full fields recorded as floats, hence the tolerance
+  const double eps = 1e-6;
+  blitz::Array<float, 3> a(nx, ny, nz), b(nx, ny, nz);
+  for (int r = 0; r < int(n_rec); ++r)
+  {
+    std::ostringstream name;
+    name << outdir << "/timestep" << std::setw(10) << std::setfill('0') << r * outfreq << ".h5";
+    H5::H5File h5(name.str(), H5F_ACC_RDONLY);
+    h5.openDataSet("a").read(a.data(), H5::PredType::NATIVE_FLOAT);
+    h5.openDataSet("b").read(b.data(), H5::PredType::NATIVE_FLOAT);
+
+    for (int k = 0; k < nz; ++k)
+    {
+      const auto al = a(blitz::Range::all(), blitz::Range::all(), k), bl = b(blitz::Range::all(), blitz::Range::all(), k);
+      const double am = blitz::mean(al), bm = blitz::mean(bl);
+      if (std::abs(mean(r, k) - am) > eps) throw std::runtime_error("level mean");
+      if (std::abs(cov(r, k) - blitz::mean((al - am) * (bl - bm))) > eps) throw std::runtime_error("level covariance");
+      if (std::abs(mn(r, k) - blitz::min(al)) > eps) throw std::runtime_error("level min");
+      if (std::abs(mx(r, k) - blitz::max(al)) > eps) throw std::runtime_error("level max");
+    }
+
+    if (blitz::sum(hist(r, blitz::Range::all())) != nx * ny * nz)
+      throw std::runtime_error("histogram does not count all cells");
+    // the highest bin takes values above the range
+    if (hist(r, n_bins - 1) != blitz::count(b >= 1 - 1. / n_bins))
+      throw std::runtime_error("histogram bins");
+  }
+}
@@ -0,0 +1,116 @@
+/**
+ * @file
+ * @copyright University of Warsaw
+ * @section LICENSE
+ * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
+ *
+ * checks if skipping the exchanges of still-valid advectee halos (xchng_tracking) skips
+ * the expected ones (incl. the exchange after update_rhs() in the hooks) and gives
+ * bitwise the same results as always filling the halos (built also as xchng_tracking_check
+ * with LIBMPDATAXX_CHECK_XCHNG_TRACKING, i.e. with the skipped exchanges done and checked)
+ */
+
+#include <libmpdata++/solvers/mpdata_rhs.hpp>
+#include <libmpdata++/concurr/threads.hpp>
+
+using namespace libmpdataxx;
+
+template <bool tracking>
+struct ct_params_t : ct_params_default_t
+{
+  using real_t = double;
+  enum { n_dims = 3 };
+  enum { n_eqns = 2 };
+  enum { rhs_scheme = solvers::euler_a };
+  enum { hint_norhs = opts::bit(1) };
+  enum { xchng_tracking = tracking };
+};
+
+const int nt = 20;
+
+// skipped exchanges of the thread of rank 0
+long long int n_skipped = -1;
+
+template <bool tracking>
+class slv_t : public solvers::mpdata_rhs<ct_params_t<tracking>>
+{
+  using parent_t = solvers::mpdata_rhs<ct_params_t<tracking>>;
+
+  // the rhs of the first equation depends on the halo of the second one
+  void update_rhs(
+    arrvec_t<typename parent_t::arr_t> &rhs,
+    const typename parent_t::real_t &dt,
+    const int &at
+  )
+  {
+    parent_t::update_rhs(rhs, dt, at); // fills the halos of both equations
+    this->xchng(1); // skipped
+
+    const auto &psi = this->state(1);
+    const auto &i = this->i, &j = this->j, &k = this->k;
+    rhs.at(0)(this->ijk) = -.1 * (psi(i+1, j, k) - psi(i-1, j, k) + psi(i, j, k+1) - psi(i, j, k-1));
+  }
+
+  public:
+
+  using parent_t::parent_t;
+
+  ~slv_t()
+  {
+    if (this->rank == 0) n_skipped = this->n_xchng_skipped;
+  }
+};
+
+template <bool tracking>
+std::array<blitz::Array<double, 3>, 2> run()
+{
+  typename slv_t<tracking>::rt_params_t p;
+  p.grid_size = {23, 19, 17};
+  p.dt = 1;
+
+  concurr::threads<
+    slv_t<tracking>,
+    bcond::cyclic, bcond::cyclic,
+    bcond::cyclic, bcond::cyclic,
+    bcond::cyclic, bcond::cyclic
+  > slv(p);
+
+  blitz::firstIndex i;
+  blitz::secondIndex j;
+  blitz::thirdIndex k;
+  slv.advectee(0) = 1 + exp(-(pow2(i - 11.) + pow2(j - 9.) + pow2(k - 8.)) / 10);
+  slv.advectee(1) = 2 + sin(i / 3.) * cos(k / 4.);
+  slv.advector(0) = .2;
+  slv.advector(1) = .1;
+  slv.advector(2) = -.15;
+
+  slv.advance(nt);
+
+  return {{slv.advectee(0).copy(), slv.advectee(1).copy()}};
+}
+
+int main()
+{
+#if defined(USE_MPI)
+  // we will instantiate many solvers, so we have to init mpi manually,
+  // because solvers will not know should they finalize mpi upon destruction
+  MPI::Init_thread(MPI_THREAD_MULTIPLE);
+#endif
+
+  const auto ref = run<false>();
+  if (n_skipped != 0)
+    throw std::runtime_error("exchanges skipped with xchng_tracking disabled");
+
+  const auto trk = run<true>();
+  // per timestep: the explicit one in update_rhs() and both of the ones before advection
+  if (n_skipped != 3 * nt)
+    throw std::runtime_error("unexpected number of skipped exchanges: " + std::to_string(n_skipped));
+
+  for (int e = 0; e < 2; ++e)
+    if (any(ref[e] != trk[e]))
+      throw std::runtime_error("xchng_tracking result differs");
+
+#if defined(USE_MPI)
+  MPI::Finalize();
+#endif
+}